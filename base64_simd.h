@@ -0,0 +1,266 @@
+#ifndef BASE64_SIMD_H
+#define BASE64_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BASE64_SIMD_X86 1
+#endif
+
+// Standard-alphabet Base64 with '=' padding, byte-compatible with Crypto++'s Base64Encoder
+// (no line breaks) and Base64Decoder, writing straight into caller-provided buffers.
+// On x86 the bulk of the input goes through AVX2 (24 bytes <-> 32 chars per step) or
+// SSSE3 (12 <-> 16), selected at runtime; tails and other CPUs use the scalar code.
+// The SIMD encoder follows Wojciech Mula's pshufb/multiply bit-unpacking scheme.
+
+const size_t kBase64Invalid = static_cast<size_t>(-1);
+
+inline size_t base64_encoded_size(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+inline size_t base64_decoded_max_size(size_t length) {
+    return length / 4 * 3 + 3;
+}
+
+namespace base64_detail {
+
+static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline size_t encode_scalar(const unsigned char *in, size_t length, char *out) {
+    char *start = out;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+        *out++ = kAlphabet[v >> 18];
+        *out++ = kAlphabet[(v >> 12) & 63];
+        *out++ = kAlphabet[(v >> 6) & 63];
+        *out++ = kAlphabet[v & 63];
+    }
+    if (i < length) {
+        uint32_t v = in[i] << 16;
+        if (i + 1 < length) {
+            v |= in[i + 1] << 8;
+        }
+        *out++ = kAlphabet[v >> 18];
+        *out++ = kAlphabet[(v >> 12) & 63];
+        *out++ = i + 1 < length ? kAlphabet[(v >> 6) & 63] : '=';
+        *out++ = '=';
+    }
+    return out - start;
+}
+
+inline int decode_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// Decodes the remainder, skipping whitespace and stopping at '=' padding
+inline size_t decode_scalar(const char *in, size_t length, unsigned char *out) {
+    unsigned char *start = out;
+    uint32_t acc = 0;
+    int bits = 0;
+    size_t i = 0;
+    for (; i < length && in[i] != '='; i++) {
+        if (is_space(in[i])) {
+            continue;
+        }
+        int v = decode_value(in[i]);
+        if (v < 0) {
+            return kBase64Invalid;
+        }
+        acc = (acc << 6) | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *out++ = static_cast<unsigned char>(acc >> bits);
+        }
+    }
+    for (; i < length; i++) {
+        if (in[i] != '=' && !is_space(in[i])) {
+            return kBase64Invalid;
+        }
+    }
+    return out - start;
+}
+
+#ifdef BASE64_SIMD_X86
+
+// 16 sextets (one per byte, in order) -> 16 ASCII characters
+__attribute__((target("ssse3"))) inline __m128i sextets_to_ascii(__m128i indices) {
+    const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0);
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+}
+
+// 12 input bytes (in lanes 0..11) -> 16 sextets
+__attribute__((target("ssse3"))) inline __m128i bytes_to_sextets(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t0, t1);
+}
+
+__attribute__((target("ssse3"))) inline size_t encode_ssse3(const unsigned char *in, size_t length, char *out) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 12, out += 16) {  // loads 16 bytes, consumes 12
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), sextets_to_ascii(bytes_to_sextets(chunk)));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline size_t encode_avx2(const unsigned char *in, size_t length, char *out) {
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                               '/' - 63, 'A', 0, 0,
+                                               'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                               '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    for (; i + 28 <= length; i += 24, out += 32) {  // each 128-bit lane takes 12 bytes
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 12));
+        __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+        __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t0, t1);
+        __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        __m256i ascii = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), ascii);
+    }
+    return i;
+}
+
+// ASCII -> sextets by range classification; returns false if any byte is outside the alphabet
+__attribute__((target("ssse3"))) inline bool ascii_to_sextets(__m128i in, __m128i &values) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+    __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+        return false;
+    }
+    __m128i shift = _mm_or_si128(_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-65)), _mm_and_si128(lower, _mm_set1_epi8(-71))),
+                                 _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(4)),
+                                              _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(19)), _mm_and_si128(slash, _mm_set1_epi8(16)))));
+    values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+// 16 sextets -> 12 bytes in lanes 0..11
+__attribute__((target("ssse3"))) inline __m128i sextets_to_bytes(__m128i values) {
+    __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// Decodes whole 16-char blocks; stops at the first block holding padding or whitespace
+__attribute__((target("ssse3"))) inline size_t decode_ssse3(const char *in, size_t length, unsigned char *out, size_t &written) {
+    size_t i = 0;
+    written = 0;
+    for (; i + 16 <= length; i += 16, written += 12) {
+        __m128i values;
+        if (!ascii_to_sextets(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), values)) {
+            break;
+        }
+        unsigned char block[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block), sextets_to_bytes(values));
+        std::memcpy(out + written, block, 12);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline size_t decode_avx2(const char *in, size_t length, unsigned char *out, size_t &written) {
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    written = 0;
+    for (; i + 32 <= length; i += 32, written += 24) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+        __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        __m256i plus = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('+'));
+        __m256i slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+        __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu) {
+            break;
+        }
+        __m256i shift = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-65)), _mm256_and_si256(lower, _mm256_set1_epi8(-71))),
+                                        _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(4)),
+                                                        _mm256_or_si256(_mm256_and_si256(plus, _mm256_set1_epi8(19)), _mm256_and_si256(slash, _mm256_set1_epi8(16)))));
+        __m256i merged = _mm256_maddubs_epi16(_mm256_add_epi8(v, shift), _mm256_set1_epi32(0x01400140));
+        merged = _mm256_shuffle_epi8(_mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000)), pack);
+        unsigned char block[32];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(block), merged);
+        std::memcpy(out + written, block, 12);
+        std::memcpy(out + written + 12, block + 16, 12);
+    }
+    return i;
+}
+
+inline int simd_level() {
+    static const int level = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("ssse3") ? 1 : 0;
+    return level;
+}
+
+#endif  // BASE64_SIMD_X86
+
+}  // namespace base64_detail
+
+// Writes base64_encoded_size(length) characters to out (no terminator); returns that count
+inline size_t base64_encode(const unsigned char *in, size_t length, char *out) {
+    size_t consumed = 0;
+#ifdef BASE64_SIMD_X86
+    int level = base64_detail::simd_level();
+    if (level == 2) {
+        consumed = base64_detail::encode_avx2(in, length, out);
+    } else if (level == 1) {
+        consumed = base64_detail::encode_ssse3(in, length, out);
+    }
+#endif
+    return consumed / 3 * 4 + base64_detail::encode_scalar(in + consumed, length - consumed, out + consumed / 3 * 4);
+}
+
+// out must hold base64_decoded_max_size(length) bytes. Leading/trailing whitespace is
+// ignored. Returns the number of bytes written, or kBase64Invalid on malformed input.
+inline size_t base64_decode(const char *in, size_t length, unsigned char *out) {
+    while (length > 0 && base64_detail::is_space(*in)) {
+        in++;
+        length--;
+    }
+    size_t consumed = 0, written = 0;
+#ifdef BASE64_SIMD_X86
+    int level = base64_detail::simd_level();
+    if (level == 2) {
+        consumed = base64_detail::decode_avx2(in, length, out, written);
+    } else if (level == 1) {
+        consumed = base64_detail::decode_ssse3(in, length, out, written);
+    }
+#endif
+    size_t tail = base64_detail::decode_scalar(in + consumed, length - consumed, out + written);
+    return tail == kBase64Invalid ? kBase64Invalid : written + tail;
+}
+
+#endif  // BASE64_SIMD_H
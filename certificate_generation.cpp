@@ -1,47 +1,15 @@
 #include <cryptopp/dsa.h>
 #include <cryptopp/osrng.h>
 #include <cryptopp/files.h>
-#include <cryptopp/sha.h>
-#include <cryptopp/hex.h>
-#include <cryptopp/base64.h>
-#include <cryptopp/filters.h>
 #include <cryptopp/integer.h>
 #include <iostream>
-#include <sstream>
-#include <vector>
+#include <fstream>
 #include <ctime>
+#include "certificate_issuer.h"
+#include "expiry_index.h"
 
 using namespace CryptoPP;
 
-std::string get_current_date() {
-    std::time_t now = std::time(nullptr);
-    char buf[80];
-    std::strftime(buf, sizeof(buf), "%a, %d %b %Y", std::localtime(&now));
-    return std::string(buf);
-}
-
-std::string get_expiration_date() {
-    std::time_t now = std::time(nullptr);
-    std::tm expiration = *std::localtime(&now);
-    expiration.tm_year += 2;  // Two years later
-    std::mktime(&expiration);
-    char buf[80];
-    std::strftime(buf, sizeof(buf), "%a, %d %b %Y", &expiration);
-    return std::string(buf);
-}
-
-std::string encode_public_key(const Integer& publicKey) {
-    // Encode the public key as a byte array
-    size_t size = publicKey.MinEncodedSize();
-    std::vector<byte> encoded(size);
-    publicKey.Encode(encoded.data(), encoded.size());
-
-    // Convert the byte array to a base64 string
-    std::string encodedStr;
-    StringSource ss(encoded.data(), encoded.size(), true, new Base64Encoder(new StringSink(encodedStr), false));
-    return encodedStr;
-}
-
 void sign_certificate(const std::string &userEmail, const std::string &caPrivKeyFile, const std::string &userPubKeyFile, const std::string &certFile) {
     AutoSeededRandomPool rng;
 
@@ -60,45 +28,35 @@ void sign_certificate(const std::string &userEmail, const std::string &caPrivKey
     pubFile >> userPublicKey;
     pubFile.close();
 
-    // Prepare the certificate data
-    std::ostringstream certificateData;
-    certificateData << "Issuer Name: IIITA\n";
-    certificateData << "Subject ID: " << userEmail << "\n";
-    certificateData << "Validity:\n";
-    certificateData << "    NotBefore: " << get_current_date() << "\n";
-    certificateData << "    NotAfter: " << get_expiration_date() << "\n";
-    certificateData << "Signature Algorithm: DSA\n";
-
-    // Encode the public key to a base64 string
-    std::string userPubKeyStr = encode_public_key(userPublicKey);
-    certificateData << "Subject Public Key: (Diffie-Hellman) " << userPubKeyStr << "\n";
-
-    // Hash the certificate data
-    std::string certDataStr = certificateData.str();
-    SHA256 hash;
-    std::string digest;
-    StringSource(certDataStr, true, new HashFilter(hash, new StringSink(digest)));
-
-    // Sign the hash with the CA's private key
-    DSA::Signer signer(caPrivateKey);
-    std::string signature;
-    StringSource ss2(digest, true, new SignerFilter(rng, signer, new StringSink(signature)));
-
-    // Encode the signature as base64
-    std::string encodedSignature;
-    StringSource ss3(signature, true, new Base64Encoder(new StringSink(encodedSignature), false));
-
-    // Complete the certificate with the signature
-    certificateData << "Signature: " << encodedSignature << "\n";
+    // Assign the certificate a serial number so it can be revoked later
+    uint64_t serial = next_serial_number("CA_Serial.bin");
+    if (serial == 0) {
+        std::cerr << "Error: Unable to assign a serial number from CA_Serial.bin" << std::endl;
+        return;
+    }
+
+    // Build and sign the certificate with the CA's private key
+    std::time_t notAfter = get_expiration_time();
+    std::string certificate = build_signed_certificate(userEmail, serial, std::time(nullptr), notAfter,
+                                                       userPublicKey, caPrivateKey, rng);
 
     // Save the certificate to a file
     std::ofstream certFileOut(certFile);
     if (certFileOut) {
-        certFileOut << certificateData.str();
+        certFileOut << certificate;
         certFileOut.close();
         std::cout << "Certificate generated and saved as " << certFile << "." << std::endl;
     } else {
         std::cerr << "Error: Unable to save certificate to " << certFile << std::endl;
+        return;
+    }
+
+    // Register the certificate so rotate_certificates can find it when it nears NotAfter
+    ExpiryIndex expiryIndex;
+    ExpiryRecord record;
+    if (!ExpiryIndex::make_record(record, notAfter, serial, userEmail, certFile, userPubKeyFile) ||
+        !expiryIndex.open("CA_Expiry.bin") || !expiryIndex.add(record)) {
+        std::cerr << "Error: Unable to register " << certFile << " in CA_Expiry.bin" << std::endl;
     }
 }
 
@@ -0,0 +1,99 @@
+#ifndef CERTIFICATE_ISSUER_H
+#define CERTIFICATE_ISSUER_H
+
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cryptopp/dsa.h>
+#include <cryptopp/sha.h>
+#include <cryptopp/filters.h>
+#include <cryptopp/integer.h>
+#include "base64_simd.h"
+
+// Certificate issuance shared by certificate_generation, rotate_certificates and
+// simulate_parties, so every path hands out serials, lifetimes and certificate text the
+// same way. The private key sampler lives in private_key.h.
+
+// Hand out the next serial number from the CA's counter file. flock keeps concurrent
+// issuers from reusing a serial. Returns 0 on failure; valid serials start at 1.
+inline uint64_t next_serial_number(const std::string &counterFile) {
+    int fd = open(counterFile.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return 0;
+    }
+    flock(fd, LOCK_EX);
+    char buf[32] = {0};
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    uint64_t serial = (n > 0 ? std::strtoull(buf, nullptr, 10) : 0) + 1;
+    std::string text = std::to_string(serial) + "\n";
+    bool ok = ftruncate(fd, 0) == 0 && pwrite(fd, text.data(), text.size(), 0) == static_cast<ssize_t>(text.size());
+    flock(fd, LOCK_UN);
+    close(fd);
+    return ok ? serial : 0;
+}
+
+// NotBefore/NotAfter format, the one verify_certificate parses
+inline std::string format_certificate_date(std::time_t when) {
+    std::tm date;
+    localtime_r(&when, &date);
+    char buf[80];
+    std::strftime(buf, sizeof(buf), "%a, %d %b %Y", &date);
+    return std::string(buf);
+}
+
+// Start of the day two years from now, the instant verify_certificate compares NotAfter against
+inline std::time_t get_expiration_time() {
+    std::time_t now = std::time(nullptr);
+    std::tm expiration;
+    localtime_r(&now, &expiration);
+    expiration.tm_year += 2;  // Two years later
+    expiration.tm_hour = expiration.tm_min = expiration.tm_sec = 0;
+    expiration.tm_isdst = -1;
+    return std::mktime(&expiration);
+}
+
+inline std::string encode_public_key(const CryptoPP::Integer &publicKey) {
+    std::vector<CryptoPP::byte> encoded(publicKey.MinEncodedSize());
+    publicKey.Encode(encoded.data(), encoded.size());
+    std::string encodedStr(base64_encoded_size(encoded.size()), '\0');
+    base64_encode(encoded.data(), encoded.size(), &encodedStr[0]);
+    return encodedStr;
+}
+
+// The complete certificate text: the signed fields followed by the Base64 DSA signature
+// over their SHA-256 digest
+inline std::string build_signed_certificate(const std::string &subject, uint64_t serial, std::time_t notBefore,
+                                            std::time_t notAfter, const CryptoPP::Integer &publicKey,
+                                            const CryptoPP::DSA::PrivateKey &caPrivateKey,
+                                            CryptoPP::RandomNumberGenerator &rng) {
+    std::ostringstream certificateData;
+    certificateData << "Issuer Name: IIITA\n";
+    certificateData << "Serial Number: " << serial << "\n";
+    certificateData << "Subject ID: " << subject << "\n";
+    certificateData << "Validity:\n";
+    certificateData << "    NotBefore: " << format_certificate_date(notBefore) << "\n";
+    certificateData << "    NotAfter: " << format_certificate_date(notAfter) << "\n";
+    certificateData << "Signature Algorithm: DSA\n";
+    certificateData << "Subject Public Key: (Diffie-Hellman) " << encode_public_key(publicKey) << "\n";
+
+    std::string certDataStr = certificateData.str();
+    CryptoPP::SHA256 hash;
+    std::string digest;
+    CryptoPP::StringSource(certDataStr, true, new CryptoPP::HashFilter(hash, new CryptoPP::StringSink(digest)));
+
+    CryptoPP::DSA::Signer signer(caPrivateKey);
+    std::string signature;
+    CryptoPP::StringSource(digest, true, new CryptoPP::SignerFilter(rng, signer, new CryptoPP::StringSink(signature)));
+
+    std::string encodedSignature(base64_encoded_size(signature.size()), '\0');
+    base64_encode(reinterpret_cast<const CryptoPP::byte *>(signature.data()), signature.size(), &encodedSignature[0]);
+    return certDataStr + "Signature: " + encodedSignature + "\n";
+}
+
+#endif  // CERTIFICATE_ISSUER_H
@@ -0,0 +1,362 @@
+#ifndef CERTIFICATE_VERIFIER_H
+#define CERTIFICATE_VERIFIER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cryptopp/dsa.h>
+#include <cryptopp/files.h>
+#include <cryptopp/sha.h>
+#include <cryptopp/filters.h>
+#include "revocation.h"
+#include "base64_simd.h"
+
+// Certificate checks shared by verify_certificate and simulate_parties: validity window,
+// revocation and the CA's DSA signature, for a single certificate or a whole bundle.
+
+inline bool IsDateWithinRange(const std::string& notBefore, const std::string& notAfter) {
+    std::time_t now = std::time(nullptr);
+    
+    auto parseDate = [](const std::string& dateStr) -> std::time_t {
+        std::tm tm = {};
+        std::istringstream ss(dateStr);
+        ss >> std::get_time(&tm, "%a, %d %b %Y");
+        return std::mktime(&tm);
+    };
+    
+    std::time_t notBeforeTime = parseDate(notBefore);
+    std::time_t notAfterTime = parseDate(notAfter);
+    
+    return (now >= notBeforeTime && now <= notAfterTime);
+}
+
+// Certificates issued before serial numbers were introduced cannot be revoked
+inline bool IsRevoked(const std::string& serialField, const RevocationIndex* revocations) {
+    if (revocations == nullptr || serialField.empty()) {
+        return false;
+    }
+    return revocations->is_revoked(std::strtoull(serialField.c_str(), nullptr, 10));
+}
+
+// Fixed-capacity queue connecting two pipeline stages. push() blocks while the queue is
+// full, which is what keeps bundle verification memory flat regardless of bundle size.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity, int producers = 1) : capacity(capacity), producers(producers) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+    }
+
+    // Returns false once every producer has closed and the queue is drained
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return !items.empty() || producers == 0; });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--producers == 0) {
+            not_empty.notify_all();
+        }
+    }
+
+private:
+    size_t capacity;
+    int producers;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+// One certificate travelling through the bundle pipeline. data/size point into the
+// memory-mapped bundle; only the decoded signature and digest are owned.
+struct CertJob {
+    size_t index = 0;
+    const char *data = nullptr;
+    size_t size = 0;
+    size_t signedSize = 0;
+    std::string subject;
+    std::string serial;
+    std::string notBefore;
+    std::string notAfter;
+    std::string signature;
+    std::string digest;
+    std::string error;
+};
+
+// Crypto++ reports a missing or malformed key by throwing; turn that into an error message
+inline bool LoadCAPublicKey(const std::string &path, CryptoPP::DSA::PublicKey &caPublicKey) {
+    try {
+        CryptoPP::FileSource file(path.c_str(), true);
+        caPublicKey.Load(file);
+    } catch (const CryptoPP::Exception &e) {
+        std::cerr << "Error: Unable to load CA public key " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline std::string field_value(const char *data, size_t size, const char *label) {
+    const char *pos = static_cast<const char *>(memmem(data, size, label, std::strlen(label)));
+    if (pos == nullptr) {
+        return std::string();
+    }
+    pos += std::strlen(label);
+    const char *end = static_cast<const char *>(std::memchr(pos, '\n', data + size - pos));
+    return std::string(pos, end ? end : data + size);
+}
+
+// Check one certificate: validity window, revocation, then the signature. On failure
+// error holds the message verify_certificate prints.
+inline bool verify_certificate_text(const std::string &certificate, const CryptoPP::DSA::PublicKey &caPublicKey,
+                                    const RevocationIndex *revocations, std::string &error) {
+    // Extract validity period
+    size_t notBeforePos = certificate.find("NotBefore: ");
+    size_t notAfterPos = certificate.find("NotAfter: ");
+    if (notBeforePos == std::string::npos || notAfterPos == std::string::npos) {
+        error = "Validity period not found in certificate.";
+        return false;
+    }
+
+    std::string notBefore = certificate.substr(notBeforePos + 11, 16); // 11 to skip "NotBefore: "
+    std::string notAfter = certificate.substr(notAfterPos + 10, 16);  // 10 to skip "NotAfter: "
+
+    // Check if the certificate is within its validity period
+    if (!IsDateWithinRange(notBefore, notAfter)) {
+        error = "Certificate is not within its validity period.";
+        return false;
+    }
+
+    // Check the serial number against the revocation index
+    size_t serialPos = certificate.find("Serial Number: ");
+    if (serialPos != std::string::npos &&
+        IsRevoked(certificate.substr(serialPos + 15, certificate.find('\n', serialPos) - serialPos - 15), revocations)) {
+        error = "Certificate has been revoked.";
+        return false;
+    }
+
+    // Find the signature position
+    size_t signaturePos = certificate.find("Signature: ");
+    if (signaturePos == std::string::npos) {
+        error = "Signature not found in certificate.";
+        return false;
+    }
+
+    std::string certData = certificate.substr(0, signaturePos);
+    std::string encodedSignature = certificate.substr(signaturePos + 10); // 10 = length of "Signature: "
+
+    // Decode the Base64-encoded signature
+    std::string signature(base64_decoded_max_size(encodedSignature.size()), '\0');
+    size_t signatureSize = base64_decode(encodedSignature.data(), encodedSignature.size(),
+                                         reinterpret_cast<CryptoPP::byte *>(&signature[0]));
+    if (signatureSize == kBase64Invalid) {
+        error = "Signature is not valid Base64.";
+        return false;
+    }
+    signature.resize(signatureSize);
+
+    // Hash the certificate data with SHA-256 and verify the signature using DSA
+    try {
+        CryptoPP::SHA256 hash;
+        std::string digest;
+        CryptoPP::StringSource(certData, true, new CryptoPP::HashFilter(hash, new CryptoPP::StringSink(digest)));
+        CryptoPP::DSA::Verifier verifier(caPublicKey);
+        if (verifier.VerifyMessage((const CryptoPP::byte*)digest.data(), digest.size(),
+                                   (const CryptoPP::byte*)signature.data(), signature.size())) {
+            return true;
+        }
+        error = "Certificate verification failed.";
+    } catch (const CryptoPP::Exception &e) {
+        error = std::string("Certificate verification failed: ") + e.what();
+    }
+    return false;
+}
+
+// Verify concatenated certificates through a split -> parse -> hash -> DSA verify ->
+// validity pipeline connected by bounded queues, so memory stays flat however large the
+// bundle is. onResult(const CertJob &) runs on the calling thread for every certificate,
+// in completion order; job.error is empty when the certificate verified.
+template <class ResultSink>
+void verify_bundle_data(const char *bundle, size_t bundleSize, const CryptoPP::DSA::PublicKey &caPublicKey,
+                        const RevocationIndex *revocations, ResultSink onResult) {
+    const size_t kQueueDepth = 1024;
+
+    unsigned int verifyThreads = std::max(1u, std::thread::hardware_concurrency());
+    BoundedQueue<CertJob> splitQueue(kQueueDepth);
+    BoundedQueue<CertJob> parseQueue(kQueueDepth);
+    BoundedQueue<CertJob> hashQueue(kQueueDepth);
+    BoundedQueue<CertJob> verifyQueue(kQueueDepth, verifyThreads);
+    BoundedQueue<CertJob> resultQueue(kQueueDepth);
+
+    // Split: every certificate starts with an "Issuer Name: " line, so a job runs from one
+    // of those to the next. A certificate missing its Signature line then fails on its own
+    // instead of swallowing the certificate after it.
+    std::thread splitter([&] {
+        static const char kIssuerLine[] = "\nIssuer Name: ";
+        static const char kSignatureLine[] = "\nSignature: ";
+        const char *bundleEnd = bundle + bundleSize;
+        size_t offset = 0, index = 0;
+        // Skip blank separators between concatenated certificates
+        while (offset < bundleSize && (bundle[offset] == '\n' || bundle[offset] == '\r')) {
+            offset++;
+        }
+        while (offset < bundleSize) {
+            const char *start = bundle + offset;
+            const char *next = static_cast<const char *>(memmem(start, bundleEnd - start, kIssuerLine, sizeof(kIssuerLine) - 1));
+            const char *end = next ? next + 1 : bundleEnd;
+            CertJob job;
+            job.index = index++;
+            job.data = start;
+            job.size = static_cast<size_t>(end - start);
+            const char *sig = static_cast<const char *>(memmem(start, job.size, kSignatureLine, sizeof(kSignatureLine) - 1));
+            const char *sigEnd = sig ? static_cast<const char *>(std::memchr(sig + 1, '\n', end - (sig + 1))) : nullptr;
+            if (std::strncmp(start, kIssuerLine + 1, std::min(job.size, sizeof(kIssuerLine) - 2)) != 0) {
+                job.error = "Certificate does not start with Issuer Name.";
+            } else if (memmem(start + 1, job.size - 1, kIssuerLine + 1, sizeof(kIssuerLine) - 2) != nullptr) {
+                // Only possible when a certificate runs into the next one mid-line
+                job.error = "Certificate contains a second Issuer Name.";
+            } else if (sig == nullptr) {
+                job.error = "Signature not found in certificate.";
+            } else {
+                job.signedSize = static_cast<size_t>(sig + 1 - start);
+                job.size = static_cast<size_t>((sigEnd ? sigEnd + 1 : end) - start);
+                if (std::any_of(start + job.size, end, [](char c) { return c != '\n' && c != '\r'; })) {
+                    job.error = "Unexpected data after the Signature line.";
+                }
+            }
+            offset = static_cast<size_t>(end - bundle);
+            splitQueue.push(std::move(job));
+        }
+        splitQueue.close();
+    });
+
+    // Parse: pull out the fields and decode the Base64 signature
+    std::thread parser([&] {
+        CertJob job;
+        while (splitQueue.pop(job)) {
+            if (job.error.empty()) {
+                job.subject = field_value(job.data, job.signedSize, "Subject ID: ");
+                job.serial = field_value(job.data, job.signedSize, "Serial Number: ");
+                job.notBefore = field_value(job.data, job.signedSize, "NotBefore: ").substr(0, 16);
+                job.notAfter = field_value(job.data, job.signedSize, "NotAfter: ").substr(0, 16);
+                if (job.notBefore.empty() || job.notAfter.empty()) {
+                    job.error = "Validity period not found in certificate.";
+                } else {
+                    const char *encoded = job.data + job.signedSize + 10;  // 10 = length of "Signature:"
+                    size_t encodedSize = static_cast<size_t>(job.data + job.size - encoded);
+                    job.signature.resize(base64_decoded_max_size(encodedSize));
+                    size_t decoded = base64_decode(encoded, encodedSize, reinterpret_cast<CryptoPP::byte *>(&job.signature[0]));
+                    if (decoded == kBase64Invalid) {
+                        job.error = "Signature is not valid Base64.";
+                    } else {
+                        job.signature.resize(decoded);
+                    }
+                }
+            } else {
+                job.subject = field_value(job.data, job.size, "Subject ID: ");
+            }
+            parseQueue.push(std::move(job));
+        }
+        parseQueue.close();
+    });
+
+    // The hash and verify stages call into Crypto++, which reports bad input by throwing.
+    // They catch per job: an exception escaping a worker thread would call std::terminate.
+
+    // Hash: SHA-256 over everything before the signature line
+    std::thread hasher([&] {
+        CryptoPP::SHA256 hash;
+        CertJob job;
+        while (parseQueue.pop(job)) {
+            if (job.error.empty()) {
+                try {
+                    CryptoPP::StringSource(reinterpret_cast<const CryptoPP::byte *>(job.data), job.signedSize, true,
+                                 new CryptoPP::HashFilter(hash, new CryptoPP::StringSink(job.digest)));
+                } catch (const CryptoPP::Exception &e) {
+                    job.error = e.what();
+                }
+            }
+            hashQueue.push(std::move(job));
+        }
+        hashQueue.close();
+    });
+
+    // DSA verify: the expensive stage, fanned out across all cores
+    std::vector<std::thread> verifiers;
+    for (unsigned int t = 0; t < verifyThreads; t++) {
+        verifiers.emplace_back([&] {
+            CryptoPP::DSA::Verifier verifier(caPublicKey);
+            CertJob job;
+            while (hashQueue.pop(job)) {
+                if (job.error.empty()) {
+                    // VerifyMessage throws InvalidDataFormat on a malformed signature
+                    try {
+                        if (!verifier.VerifyMessage((const CryptoPP::byte*)job.digest.data(), job.digest.size(),
+                                                    (const CryptoPP::byte*)job.signature.data(), job.signature.size())) {
+                            job.error = "Certificate verification failed.";
+                        }
+                    } catch (const CryptoPP::Exception &e) {
+                        job.error = std::string("Certificate verification failed: ") + e.what();
+                    }
+                }
+                verifyQueue.push(std::move(job));
+            }
+            verifyQueue.close();
+        });
+    }
+
+    // Validity and revocation check: cheap next to DSA verify, so one thread keeps up.
+    // IsDateWithinRange is itself thread-safe (glibc's mktime locks the timezone state)
+    // and simulate_parties calls it from every worker.
+    std::thread validator([&] {
+        CertJob job;
+        while (verifyQueue.pop(job)) {
+            if (job.error.empty() && !IsDateWithinRange(job.notBefore, job.notAfter)) {
+                job.error = "Certificate is not within its validity period.";
+            } else if (job.error.empty() && IsRevoked(job.serial, revocations)) {
+                job.error = "Certificate has been revoked.";
+            }
+            resultQueue.push(std::move(job));
+        }
+        resultQueue.close();
+    });
+
+    CertJob job;
+    while (resultQueue.pop(job)) {
+        onResult(job);
+    }
+
+    splitter.join();
+    parser.join();
+    hasher.join();
+    for (std::thread &verifier : verifiers) {
+        verifier.join();
+    }
+    validator.join();
+}
+
+#endif  // CERTIFICATE_VERIFIER_H
@@ -0,0 +1,299 @@
+#include <cryptopp/integer.h>
+#include <cryptopp/osrng.h>
+#include <cryptopp/aes.h>
+#include <cryptopp/gcm.h>
+#include <cryptopp/hkdf.h>
+#include <cryptopp/sha.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "secure_arena.h"
+
+using namespace CryptoPP;
+
+// Framed AES-256-GCM format for bulk data sent after the DH handshake:
+//
+//   header (40 bytes): "DHGCM001" | chunk size (u32 LE) | 0 (u32) | plaintext size (u64 LE) | salt (16)
+//   frame i:           ciphertext of chunk i | 16-byte tag
+//
+// Every frame except the last is exactly chunk size + 16 bytes, so any frame can be located
+// and decrypted independently. The nonce is the frame index, and the header is the AAD of
+// every frame, so reordering, truncation and parameter tampering all fail authentication.
+// The AES key is HKDF-SHA256(session key, salt), which makes each file's key unique.
+// Output is written to <output>.tmp and renamed into place only once every frame has been
+// written (and, when decrypting, authenticated), so a failure never clobbers an existing file.
+
+const size_t kHeaderSize = 40;
+const size_t kTagSize = 16;
+const uint32_t kDefaultChunkSize = 1 << 20;
+
+struct MappedFile {
+    unsigned char *data = nullptr;
+    size_t size = 0;
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+    }
+};
+
+// Map an existing file read-only, or create one of the given size and map it writable
+bool map_file(const std::string &path, MappedFile &file, bool create, size_t size = 0) {
+    int fd = create ? open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600) : open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || (create ? ftruncate(fd, size) : fstat(fd, &st)) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        std::cerr << "Error: Unable to open " << path << std::endl;
+        return false;
+    }
+    // ftruncate alone leaves a sparse file, and a write into a hole the disk cannot back
+    // raises SIGBUS; reserve the blocks up front so a full disk is an error here instead
+    int err = create && size > 0 ? posix_fallocate(fd, 0, static_cast<off_t>(size)) : 0;
+    if (err != 0) {
+        close(fd);
+        std::cerr << "Error: Unable to reserve space for " << path << " (" << std::strerror(err) << ")" << std::endl;
+        return false;
+    }
+    file.size = create ? size : static_cast<size_t>(st.st_size);
+    if (file.size > 0) {
+        void *ptr = mmap(nullptr, file.size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            close(fd);
+            std::cerr << "Error: Unable to map " << path << std::endl;
+            return false;
+        }
+        file.data = static_cast<unsigned char *>(ptr);
+        if (!create) {
+            madvise(ptr, file.size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+    return true;
+}
+
+// Derive the channel key from the DH session key saved by generate_*_session_key
+bool derive_channel_key(const std::string &session_key_file, const byte *salt, SecureBytes &channel_key) {
+    Integer session_key;
+    if (!load_secret_integer(session_key_file, session_key)) {
+        std::cerr << "Error: Unable to open " << session_key_file << std::endl;
+        return false;
+    }
+
+    SecureBytes session_key_bytes(session_key.MinEncodedSize());
+    session_key.Encode(session_key_bytes.data(), session_key_bytes.size());
+
+    static const char kInfo[] = "DH session channel AES-256-GCM";
+    channel_key.resize(32);
+    HKDF<SHA256> hkdf;
+    hkdf.DeriveKey(channel_key.data(), channel_key.size(), session_key_bytes.data(), session_key_bytes.size(),
+                   salt, 16, reinterpret_cast<const byte *>(kInfo), sizeof(kInfo) - 1);
+    return true;
+}
+
+// True when both paths name the same existing file (hard links and ./x vs x included)
+static bool same_file(const std::string &a, const std::string &b) {
+    struct stat sa, sb;
+    return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+// Move a fully written temporary output over the real one, or discard it
+static bool publish_output(const std::string &tmp_path, const std::string &out_path) {
+    if (std::rename(tmp_path.c_str(), out_path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        std::cerr << "Error: Unable to write " << out_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static void put_le(unsigned char *out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+static uint64_t get_le(const unsigned char *in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+static void frame_nonce(uint64_t index, byte nonce[12]) {
+    std::memset(nonce, 0, 12);
+    for (int i = 0; i < 8; i++) {
+        nonce[11 - i] = static_cast<byte>(index >> (8 * i));
+    }
+}
+
+// Run work(i) for every frame index across all cores; stops early once any frame fails
+template <class Work>
+bool for_each_frame(uint64_t frames, Work work) {
+    unsigned int threads = std::max(1u, std::min<unsigned int>(std::thread::hardware_concurrency(), frames));
+    std::atomic<uint64_t> next(0);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (uint64_t i = next++; i < frames && ok; i = next++) {
+                if (!work(i)) {
+                    ok = false;
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    return ok;
+}
+
+int encrypt_file(const std::string &session_key_file, const std::string &in_path, const std::string &out_path) {
+    AutoSeededRandomPool rng;
+    MappedFile in;
+    if (!map_file(in_path, in, false)) {
+        return 1;
+    }
+
+    uint64_t chunk = kDefaultChunkSize;
+    uint64_t frames = std::max<uint64_t>(1, (in.size + chunk - 1) / chunk);
+    unsigned char header[kHeaderSize] = {0};
+    std::memcpy(header, "DHGCM001", 8);
+    put_le(header + 8, chunk, 4);
+    put_le(header + 16, in.size, 8);
+    rng.GenerateBlock(header + 24, 16);
+
+    SecureBytes key;
+    if (!derive_channel_key(session_key_file, header + 24, key)) {
+        return 1;
+    }
+
+    std::string tmp_path = out_path + ".tmp";
+    MappedFile out;
+    if (!map_file(tmp_path, out, true, kHeaderSize + in.size + frames * kTagSize)) {
+        unlink(tmp_path.c_str());
+        return 1;
+    }
+    std::memcpy(out.data, header, kHeaderSize);
+
+    // Each worker encrypts straight from the input mapping into the output mapping
+    bool ok = for_each_frame(frames, [&](uint64_t i) {
+        thread_local GCM<AES>::Encryption enc;
+        byte nonce[12];
+        frame_nonce(i, nonce);
+        enc.SetKeyWithIV(key.data(), key.size(), nonce, sizeof(nonce));
+        size_t offset = i * chunk;
+        size_t length = std::min<size_t>(chunk, in.size - offset);
+        unsigned char *frame = out.data + kHeaderSize + i * (chunk + kTagSize);
+        enc.EncryptAndAuthenticate(frame, frame + length, kTagSize, nonce, sizeof(nonce),
+                                   header, kHeaderSize, length ? in.data + offset : nullptr, length);
+        return true;
+    });
+
+    if (!ok || msync(out.data, out.size, MS_SYNC) != 0) {
+        unlink(tmp_path.c_str());
+        std::cerr << "Error: Unable to write " << out_path << std::endl;
+        return 1;
+    }
+    if (!publish_output(tmp_path, out_path)) {
+        return 1;
+    }
+    std::cout << "Encrypted " << in.size << " bytes from " << in_path << " into " << out_path
+              << " (" << frames << " frames)." << std::endl;
+    return 0;
+}
+
+int decrypt_file(const std::string &session_key_file, const std::string &in_path, const std::string &out_path) {
+    MappedFile in;
+    if (!map_file(in_path, in, false)) {
+        return 1;
+    }
+    if (in.size < kHeaderSize || std::memcmp(in.data, "DHGCM001", 8) != 0) {
+        std::cerr << "Error: " << in_path << " is not an encrypted channel file." << std::endl;
+        return 1;
+    }
+    const unsigned char *header = in.data;
+    uint64_t chunk = get_le(header + 8, 4);
+    uint64_t plaintext_size = get_le(header + 16, 8);
+    uint64_t frames = chunk ? std::max<uint64_t>(1, (plaintext_size + chunk - 1) / chunk) : 0;
+    if (chunk == 0 || in.size != kHeaderSize + plaintext_size + frames * kTagSize) {
+        std::cerr << "Error: " << in_path << " is truncated or malformed." << std::endl;
+        return 1;
+    }
+
+    SecureBytes key;
+    if (!derive_channel_key(session_key_file, header + 24, key)) {
+        return 1;
+    }
+
+    // Plaintext lands in a temporary file until every frame has authenticated
+    std::string tmp_path = out_path + ".tmp";
+    MappedFile out;
+    if (!map_file(tmp_path, out, true, plaintext_size)) {
+        unlink(tmp_path.c_str());
+        return 1;
+    }
+
+    bool ok = for_each_frame(frames, [&](uint64_t i) {
+        thread_local GCM<AES>::Decryption dec;
+        byte nonce[12];
+        frame_nonce(i, nonce);
+        dec.SetKeyWithIV(key.data(), key.size(), nonce, sizeof(nonce));
+        size_t offset = i * chunk;
+        size_t length = std::min<size_t>(chunk, plaintext_size - offset);
+        const unsigned char *frame = in.data + kHeaderSize + i * (chunk + kTagSize);
+        return dec.DecryptAndVerify(length ? out.data + offset : nullptr, frame + length, kTagSize, nonce, sizeof(nonce),
+                                    header, kHeaderSize, frame, length);
+    });
+
+    if (!ok) {
+        // Never leave unauthenticated plaintext behind; out_path itself is untouched
+        unlink(tmp_path.c_str());
+        std::cerr << "Error: Authentication failed for " << in_path << std::endl;
+        return 1;
+    }
+    if (out.size > 0 && msync(out.data, out.size, MS_SYNC) != 0) {
+        unlink(tmp_path.c_str());
+        std::cerr << "Error: Unable to write " << out_path << std::endl;
+        return 1;
+    }
+    if (!publish_output(tmp_path, out_path)) {
+        return 1;
+    }
+    std::cout << "Decrypted " << plaintext_size << " bytes from " << in_path << " into " << out_path << "." << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc == 5 ? argv[1] : "";
+    if (mode != "encrypt" && mode != "decrypt") {
+        std::cerr << "Usage: " << argv[0] << " encrypt|decrypt <session_key_file> <input_file> <output_file>" << std::endl;
+        return 1;
+    }
+    // Truncating the output would pull the pages out from under the input mapping
+    std::string in_path = argv[3], out_path = argv[4];
+    if (in_path == out_path || same_file(in_path, out_path) || same_file(in_path, out_path + ".tmp")) {
+        std::cerr << "Error: Input and output must be different files." << std::endl;
+        return 1;
+    }
+    return mode == "encrypt" ? encrypt_file(argv[2], argv[3], argv[4]) : decrypt_file(argv[2], argv[3], argv[4]);
+}
+
+// g++ -std=c++17 -O2 -I/opt/homebrew/Cellar/cryptopp/8.9.0/include -L/opt/homebrew/Cellar/cryptopp/8.9.0/lib Lab_Codes/Lab_6/channel_crypt.cpp -lcryptopp -o channel_crypt
+
+// ./channel_crypt encrypt SSNKA.bin payload.tar payload.tar.enc
+// ./channel_crypt decrypt SSNKB.bin payload.tar.enc payload.tar
@@ -0,0 +1,235 @@
+#ifndef EXPIRY_INDEX_H
+#define EXPIRY_INDEX_H
+
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// On-disk index of issued certificates ordered by NotAfter, shared by certificate_generation
+// (which registers every certificate it issues) and rotate_certificates (which renews the
+// ones about to expire).
+//
+// Layout: header | fixed-size records sorted by not_after. Records before `head` have
+// already been rotated. Every certificate gets the same lifetime, so a new record almost
+// always belongs at the end; a rotation run reads forward from head only until it passes
+// the renewal cutoff, then swaps those records for their renewals with replace_prefix.
+// Both steps cost O(certificates due), not O(fleet). Consumed space is reclaimed once it outweighs the live records, which keeps
+// compaction amortized O(1) per rotation. The file is flock'ed while open.
+
+struct ExpiryRecord {
+    int64_t not_after;
+    uint64_t serial;
+    char subject[80];
+    char cert_file[80];
+    char pub_key_file[80];
+};
+
+struct ExpiryHeader {
+    char magic[8];
+    uint64_t head;
+    uint64_t count;
+};
+
+class ExpiryIndex {
+public:
+    ExpiryIndex() = default;
+    ExpiryIndex(const ExpiryIndex &) = delete;
+    ExpiryIndex &operator=(const ExpiryIndex &) = delete;
+    ~ExpiryIndex() { close(); }
+
+    static bool make_record(ExpiryRecord &record, std::time_t notAfter, uint64_t serial, const std::string &subject,
+                            const std::string &certFile, const std::string &pubKeyFile) {
+        std::memset(&record, 0, sizeof(record));
+        if (subject.size() >= sizeof(record.subject) || certFile.size() >= sizeof(record.cert_file) ||
+            pubKeyFile.size() >= sizeof(record.pub_key_file)) {
+            std::cerr << "Error: Subject or file name too long for the expiry index." << std::endl;
+            return false;
+        }
+        record.not_after = notAfter;
+        record.serial = serial;
+        std::memcpy(record.subject, subject.data(), subject.size());
+        std::memcpy(record.cert_file, certFile.data(), certFile.size());
+        std::memcpy(record.pub_key_file, pubKeyFile.data(), pubKeyFile.size());
+        return true;
+    }
+
+    // Open (creating if missing) and take an exclusive lock until close()
+    bool open(const std::string &indexPath) {
+        close();
+        path = indexPath;
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+        if (fd < 0 || flock(fd, LOCK_EX) != 0) {
+            std::cerr << "Error: Unable to open expiry index " << path << std::endl;
+            close();
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size == 0) {
+            header = ExpiryHeader{{'D', 'H', 'E', 'X', 'P', 'I', 'R', '1'}, 0, 0};
+            return write_header();
+        }
+        if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, "DHEXPIR1", 8) != 0) {
+            std::cerr << "Error: " << path << " is not a valid expiry index." << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Insert keeping not_after order; normally a plain append
+    bool add(const ExpiryRecord &record) {
+        uint64_t pos = header.count;
+        ExpiryRecord previous;
+        while (pos > header.head && read_record(pos - 1, previous) && previous.not_after > record.not_after) {
+            if (!write_record(pos, previous)) {
+                return false;
+            }
+            pos--;
+        }
+        if (!write_record(pos, record)) {
+            return false;
+        }
+        header.count++;
+        return write_header();
+    }
+
+    // Records with not_after <= cutoff, oldest first; reads nothing past the cutoff
+    bool due(std::time_t cutoff, std::vector<ExpiryRecord> &out) {
+        out.clear();
+        ExpiryRecord record;
+        for (uint64_t i = header.head; i < header.count; i++) {
+            if (!read_record(i, record)) {
+                return false;
+            }
+            if (record.not_after > cutoff) {
+                break;
+            }
+            out.push_back(record);
+        }
+        return true;
+    }
+
+    // Replace the first n live records (the ones just rotated) with their renewals. The
+    // renewals are written past the end and synced before the single header write that
+    // drops the old records, so a crash leaves either the old index or the new one.
+    bool replace_prefix(uint64_t n, std::vector<ExpiryRecord> records) {
+        std::stable_sort(records.begin(), records.end(),
+                         [](const ExpiryRecord &a, const ExpiryRecord &b) { return a.not_after < b.not_after; });
+        uint64_t keep = header.head + std::min(n, header.count - header.head);
+        uint64_t end = header.count;
+        ExpiryRecord record;
+        bool appendOnly = records.empty() || keep == end ||
+                          (read_record(end - 1, record) && record.not_after <= records.front().not_after);
+        ExpiryHeader next = header;
+        if (appendOnly) {
+            for (size_t i = 0; i < records.size(); i++) {
+                if (!write_record(end + i, records[i])) {
+                    return false;
+                }
+            }
+            next.head = keep;
+            next.count = end + records.size();
+        } else {
+            // Rare: a renewal sorts before a surviving record, so write a merged copy of the
+            // survivors and renewals past the end and move head onto it
+            uint64_t out = end;
+            size_t r = 0;
+            for (uint64_t i = keep; i < end; i++) {
+                if (!read_record(i, record)) {
+                    return false;
+                }
+                for (; r < records.size() && records[r].not_after < record.not_after; r++) {
+                    if (!write_record(out++, records[r])) {
+                        return false;
+                    }
+                }
+                if (!write_record(out++, record)) {
+                    return false;
+                }
+            }
+            for (; r < records.size(); r++) {
+                if (!write_record(out++, records[r])) {
+                    return false;
+                }
+            }
+            next.head = end;
+            next.count = out;
+        }
+        if (fsync(fd) != 0) {
+            std::cerr << "Error: Unable to write expiry index " << path << std::endl;
+            return false;
+        }
+        header = next;
+        if (!write_header()) {
+            return false;
+        }
+        return header.head > 1024 && header.head > header.count - header.head ? compact() : true;
+    }
+
+    uint64_t size() const {
+        return header.count - header.head;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            flock(fd, LOCK_UN);
+            ::close(fd);
+        }
+        fd = -1;
+    }
+
+private:
+    std::string path;
+    int fd = -1;
+    ExpiryHeader header;
+
+    static off_t record_offset(uint64_t index) {
+        return static_cast<off_t>(sizeof(ExpiryHeader) + index * sizeof(ExpiryRecord));
+    }
+
+    bool read_record(uint64_t index, ExpiryRecord &record) {
+        return pread(fd, &record, sizeof(record), record_offset(index)) == static_cast<ssize_t>(sizeof(record));
+    }
+
+    bool write_record(uint64_t index, const ExpiryRecord &record) {
+        if (pwrite(fd, &record, sizeof(record), record_offset(index)) != static_cast<ssize_t>(sizeof(record))) {
+            std::cerr << "Error: Unable to write expiry index " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool write_header() {
+        if (pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || fsync(fd) != 0) {
+            std::cerr << "Error: Unable to write expiry index " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Slide the live records down to the start of the file
+    bool compact() {
+        ExpiryRecord record;
+        uint64_t live = header.count - header.head;
+        for (uint64_t i = 0; i < live; i++) {
+            if (!read_record(header.head + i, record) || !write_record(i, record)) {
+                return false;
+            }
+        }
+        header.head = 0;
+        header.count = live;
+        return write_header() && ftruncate(fd, record_offset(live)) == 0;
+    }
+};
+
+#endif  // EXPIRY_INDEX_H
@@ -0,0 +1,278 @@
+#ifndef FIXED_BIGINT_H
+#define FIXED_BIGINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cryptopp/integer.h>
+
+// Fixed-width unsigned integers and Montgomery arithmetic for the modulus sizes we deploy
+// (2048- and 3072-bit p, exponents up to 256-bit q). Limbs live on the stack and every loop
+// bound is a compile-time constant so the compiler can unroll them. Anything else goes
+// through a_exp_b_mod_c_fixed's Crypto++ fallback. Since exponents are private keys, every
+// stack value derived from one is wiped before the function holding it returns; a value
+// that is returned (multiply's product, exponentiate's power) is the caller's to wipe.
+
+template <size_t Bits>
+struct FixedUInt {
+    static_assert(Bits % 64 == 0, "FixedUInt width must be a multiple of 64 bits");
+    static constexpr size_t kLimbs = Bits / 64;
+    static constexpr size_t kBytes = Bits / 8;
+
+    uint64_t limb[kLimbs];  // little-endian limb order
+
+    static FixedUInt from_integer(const CryptoPP::Integer &value) {
+        CryptoPP::byte bytes[kBytes];
+        value.Encode(bytes, kBytes);
+        FixedUInt result;
+        result.decode(bytes);
+        CryptoPP::SecureWipeBuffer(bytes, kBytes);
+        return result;
+    }
+
+    CryptoPP::Integer to_integer() const {
+        CryptoPP::byte bytes[kBytes];
+        encode(bytes);
+        CryptoPP::Integer result(bytes, kBytes);
+        CryptoPP::SecureWipeBuffer(bytes, kBytes);
+        return result;
+    }
+
+    // Big-endian, matching Integer::Decode
+    void decode(const CryptoPP::byte *bytes) {
+        for (size_t i = 0; i < kLimbs; i++) {
+            uint64_t word = 0;
+            for (size_t b = 0; b < 8; b++) {
+                word = (word << 8) | bytes[kBytes - 8 * (i + 1) + b];
+            }
+            limb[i] = word;
+        }
+    }
+
+    // Big-endian with size <= kBytes, zero-extended on the left
+    void decode(const CryptoPP::byte *bytes, size_t size) {
+        CryptoPP::byte padded[kBytes] = {0};
+        std::memcpy(padded + kBytes - size, bytes, size);
+        decode(padded);
+        CryptoPP::SecureWipeBuffer(padded, kBytes);
+    }
+
+    // Big-endian, matching Integer::Encode with a full-width buffer
+    void encode(CryptoPP::byte *bytes) const {
+        for (size_t i = 0; i < kLimbs; i++) {
+            for (size_t b = 0; b < 8; b++) {
+                bytes[kBytes - 8 * i - 1 - b] = static_cast<CryptoPP::byte>(limb[i] >> (8 * b));
+            }
+        }
+    }
+
+    bool bit(size_t index) const {
+        return (limb[index / 64] >> (index % 64)) & 1;
+    }
+
+    void wipe() {
+        CryptoPP::SecureWipeBuffer(reinterpret_cast<CryptoPP::byte *>(limb), sizeof(limb));
+    }
+};
+
+template <size_t Bits>
+class FixedMontgomery {
+public:
+    typedef FixedUInt<Bits> Value;
+    static constexpr size_t N = Value::kLimbs;
+
+    // modulus must be odd and exactly Bits wide
+    explicit FixedMontgomery(const CryptoPP::Integer &modulus) {
+        n = Value::from_integer(modulus);
+        // n0inv = -n^-1 mod 2^64 by Newton iteration
+        uint64_t inv = 1;
+        for (int i = 0; i < 6; i++) {
+            inv *= 2 - n.limb[0] * inv;
+        }
+        n0inv = 0 - inv;
+        r2 = Value::from_integer(CryptoPP::Integer::Power2(2 * Bits) % modulus);
+        std::memset(one.limb, 0, sizeof(one.limb));
+        one.limb[0] = 1;
+    }
+
+    // The context for modulus, built on first use and kept per thread. p is fixed for a
+    // run, so R^2 mod p (a heap-backed Integer division) is computed once, not per call.
+    static const FixedMontgomery &cached(const CryptoPP::Integer &modulus) {
+        thread_local CryptoPP::Integer cached_modulus;
+        thread_local FixedMontgomery context;
+        if (cached_modulus != modulus) {
+            context = FixedMontgomery(modulus);
+            cached_modulus = modulus;
+        }
+        return context;
+    }
+
+    Value to_montgomery(const Value &a) const { return multiply(a, r2); }
+    Value from_montgomery(const Value &a) const { return multiply(a, one); }
+
+    // CIOS Montgomery multiplication: a * b * R^-1 mod n
+    Value multiply(const Value &a, const Value &b) const {
+        uint64_t t[N + 2] = {0};
+        for (size_t i = 0; i < N; i++) {
+            unsigned __int128 carry = 0;
+#pragma GCC unroll 8
+            for (size_t j = 0; j < N; j++) {
+                carry += static_cast<unsigned __int128>(a.limb[j]) * b.limb[i] + t[j];
+                t[j] = static_cast<uint64_t>(carry);
+                carry >>= 64;
+            }
+            carry += t[N];
+            t[N] = static_cast<uint64_t>(carry);
+            t[N + 1] = static_cast<uint64_t>(carry >> 64);
+
+            uint64_t m = t[0] * n0inv;
+            carry = static_cast<unsigned __int128>(m) * n.limb[0] + t[0];
+            carry >>= 64;
+#pragma GCC unroll 8
+            for (size_t j = 1; j < N; j++) {
+                carry += static_cast<unsigned __int128>(m) * n.limb[j] + t[j];
+                t[j - 1] = static_cast<uint64_t>(carry);
+                carry >>= 64;
+            }
+            carry += t[N];
+            t[N - 1] = static_cast<uint64_t>(carry);
+            t[N] = t[N + 1] + static_cast<uint64_t>(carry >> 64);
+        }
+
+        // Conditional final subtraction, done unconditionally and selected by mask
+        Value result, reduced;
+        uint64_t borrow = 0;
+        for (size_t j = 0; j < N; j++) {
+            unsigned __int128 diff = static_cast<unsigned __int128>(t[j]) - n.limb[j] - borrow;
+            reduced.limb[j] = static_cast<uint64_t>(diff);
+            borrow = static_cast<uint64_t>(diff >> 64) & 1;
+        }
+        uint64_t keep = 0 - static_cast<uint64_t>(t[N] < borrow);  // all ones when t < n
+        for (size_t j = 0; j < N; j++) {
+            result.limb[j] = (t[j] & keep) | (reduced.limb[j] & ~keep);
+        }
+        CryptoPP::SecureWipeBuffer(reinterpret_cast<CryptoPP::byte *>(t), sizeof(t));
+        reduced.wipe();
+        return result;
+    }
+
+    // base^exponent mod n with a fixed 4-bit window. The window count depends only on
+    // ExpBits and table entries are read with a full masked scan, so private exponents
+    // do not leak through timing or memory access pattern.
+    template <size_t ExpBits>
+    Value exponentiate(const Value &base, const FixedUInt<ExpBits> &exponent) const {
+        Value table[16];
+        table[0] = to_montgomery(one);
+        table[1] = to_montgomery(base);
+        for (size_t i = 2; i < 16; i++) {
+            table[i] = multiply(table[i - 1], table[1]);
+        }
+
+        Value acc = table[0];
+        Value selected;
+        for (size_t window = ExpBits / 4; window-- > 0;) {
+            for (int s = 0; s < 4; s++) {
+                acc = multiply(acc, acc);
+            }
+            size_t index = 0;
+            for (int b = 3; b >= 0; b--) {
+                index = (index << 1) | exponent.bit(4 * window + b);
+            }
+            std::memset(selected.limb, 0, sizeof(selected.limb));
+            for (size_t i = 0; i < 16; i++) {
+                uint64_t mask = 0 - static_cast<uint64_t>(i == index);
+                for (size_t j = 0; j < N; j++) {
+                    selected.limb[j] |= table[i].limb[j] & mask;
+                }
+            }
+            acc = multiply(acc, selected);
+        }
+        Value result = from_montgomery(acc);
+        for (Value &entry : table) {
+            entry.wipe();
+        }
+        acc.wipe();
+        selected.wipe();
+        return result;
+    }
+
+private:
+    Value n, r2, one;
+    uint64_t n0inv;
+
+    FixedMontgomery() = default;
+};
+
+template <size_t Bits, size_t ExpBits>
+CryptoPP::Integer fixed_exp_mod(const CryptoPP::Integer &a, const CryptoPP::Integer &b, const CryptoPP::Integer &c) {
+    const FixedMontgomery<Bits> &mont = FixedMontgomery<Bits>::cached(c);
+    FixedUInt<Bits> base = FixedUInt<Bits>::from_integer(a < c ? a : a % c);
+    FixedUInt<ExpBits> exponent = FixedUInt<ExpBits>::from_integer(b);
+    FixedUInt<Bits> power = mont.exponentiate(base, exponent);
+    CryptoPP::Integer result = power.to_integer();
+    base.wipe();
+    exponent.wipe();
+    power.wipe();
+    return result;
+}
+
+// Byte-oriented counterpart: a needs no reduction, since to_montgomery brings any value
+// below 2^Bits into range
+template <size_t Bits, size_t ExpBits>
+void fixed_exp_mod(const CryptoPP::byte *a, size_t aSize, const CryptoPP::byte *b, size_t bSize,
+                   const CryptoPP::Integer &c, CryptoPP::byte *result) {
+    const FixedMontgomery<Bits> &mont = FixedMontgomery<Bits>::cached(c);
+    FixedUInt<Bits> base;
+    base.decode(a, aSize);
+    FixedUInt<ExpBits> exponent;
+    exponent.decode(b, bSize);
+    FixedUInt<Bits> power = mont.exponentiate(base, exponent);
+    power.encode(result);
+    base.wipe();
+    exponent.wipe();
+    power.wipe();
+}
+
+// Drop-in for a_exp_b_mod_c: fixed-width path for odd 2048/3072-bit moduli, Crypto++ otherwise
+inline CryptoPP::Integer a_exp_b_mod_c_fixed(const CryptoPP::Integer &a, const CryptoPP::Integer &b, const CryptoPP::Integer &c) {
+    if (c.IsOdd() && a.NotNegative() && b.NotNegative()) {
+        unsigned int modBits = c.BitCount(), expBits = b.BitCount();
+        if (modBits == 2048) {
+            return expBits <= 256 ? fixed_exp_mod<2048, 256>(a, b, c) : expBits <= 2048 ? fixed_exp_mod<2048, 2048>(a, b, c) : a_exp_b_mod_c(a, b, c);
+        }
+        if (modBits == 3072) {
+            return expBits <= 256 ? fixed_exp_mod<3072, 256>(a, b, c) : expBits <= 3072 ? fixed_exp_mod<3072, 3072>(a, b, c) : a_exp_b_mod_c(a, b, c);
+        }
+    }
+    return a_exp_b_mod_c(a, b, c);
+}
+
+// Same, for keys held as big-endian bytes: the power is written to result as c.ByteCount()
+// bytes. Every buffer is the caller's (stack or SecureArena), so once the modulus's context
+// is cached the fixed-width path never touches the heap; other widths go through Integer.
+inline void a_exp_b_mod_c_fixed(const CryptoPP::byte *a, size_t aSize, const CryptoPP::byte *b, size_t bSize,
+                                const CryptoPP::Integer &c, CryptoPP::byte *result) {
+    if (c.IsOdd()) {
+        unsigned int modBits = c.BitCount();
+        if (modBits == 2048 && aSize <= 256 && bSize <= 256) {
+            if (bSize <= 32) {
+                fixed_exp_mod<2048, 256>(a, aSize, b, bSize, c, result);
+            } else {
+                fixed_exp_mod<2048, 2048>(a, aSize, b, bSize, c, result);
+            }
+            return;
+        }
+        if (modBits == 3072 && aSize <= 384 && bSize <= 384) {
+            if (bSize <= 32) {
+                fixed_exp_mod<3072, 256>(a, aSize, b, bSize, c, result);
+            } else {
+                fixed_exp_mod<3072, 3072>(a, aSize, b, bSize, c, result);
+            }
+            return;
+        }
+    }
+    CryptoPP::Integer power = a_exp_b_mod_c(CryptoPP::Integer(a, aSize), CryptoPP::Integer(b, bSize), c);
+    power.Encode(result, c.ByteCount());
+}
+
+#endif  // FIXED_BIGINT_H
@@ -2,20 +2,10 @@
 #include <fstream>
 #include <cryptopp/integer.h>
 #include <cryptopp/osrng.h>
+#include "private_key.h"
 
 using namespace CryptoPP;
 
-void generate_private_key(Integer &private_key, const Integer &q, AutoSeededRandomPool &rng) {
-    // Generate a random number in the range [1, q-1]
-    while (true) {
-        private_key.Randomize(rng, q.BitCount() - 1);
-        // Ensure the private key is in the range [1, q-1]
-        if (private_key > 0 && private_key < q) {
-            break;
-        }
-    }
-}
-
 void generate_alice_private_key() {
     AutoSeededRandomPool rng;
     Integer g, p, q, alpha;
@@ -32,14 +22,8 @@ void generate_alice_private_key() {
     // Generate private key for Alice (α)
     generate_private_key(alpha, q, rng);
 
-    // Debug: Print the generated private key
-    std::cout << "Private Key Alpha (Alice): " << alpha << std::endl;
-
     // Save private key to file
-    std::ofstream fileA("privatekeyA.bin", std::ios::binary);
-    if (fileA) {
-        fileA << alpha;
-        fileA.close();
+    if (save_secret_integer("privatekeyA.bin", alpha)) {
         std::cout << "Private key for Alice saved to privatekeyA.bin" << std::endl;
     } else {
         std::cerr << "Error: Unable to save private key for Alice." << std::endl;
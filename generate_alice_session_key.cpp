@@ -8,6 +8,8 @@
 #include <cryptopp/md5.h>
 #include <cryptopp/hex.h>
 #include <cryptopp/osrng.h>
+#include "secure_arena.h"
+#include "fixed_bigint.h"
 
 using namespace CryptoPP;
 
@@ -15,13 +17,10 @@ void generate_session_key(const std::string &private_key_file, const std::string
     Integer private_key, other_public_key, session_key;
 
     // Load private key
-    std::ifstream priv_file(private_key_file, std::ios::binary);
-    if (!priv_file) {
+    if (!load_secret_integer(private_key_file, private_key)) {
         std::cerr << "Error: Unable to open " << private_key_file << std::endl;
         return;
     }
-    priv_file >> private_key;
-    priv_file.close();
 
     // Load the other party's public key
     std::ifstream pub_file(other_public_key_file, std::ios::binary);
@@ -33,21 +32,18 @@ void generate_session_key(const std::string &private_key_file, const std::string
     pub_file.close();
 
     // Compute the session key: SSNK ≡ (OtherPublicKey)^PrivateKey mod p
-    session_key = a_exp_b_mod_c(other_public_key, private_key, p);
+    session_key = a_exp_b_mod_c_fixed(other_public_key, private_key, p);
 
     // Save the session key to a binary file
-    std::ofstream sess_file(session_key_file, std::ios::binary);
-    if (sess_file) {
-        sess_file << session_key;
-        sess_file.close();
+    if (save_secret_integer(session_key_file, session_key)) {
         std::cout << "Session key saved to " << session_key_file << std::endl;
     } else {
         std::cerr << "Error: Unable to save session key to " << session_key_file << std::endl;
     }
 
-    // Convert session key to a byte array for MD5 hashing
+    // Convert session key to a byte array for MD5 hashing (locked arena, wiped on release)
     size_t encodedSize = session_key.MinEncodedSize();
-    std::vector<byte> session_key_bytes(encodedSize);
+    SecureBytes session_key_bytes(encodedSize);
     session_key.Encode(session_key_bytes.data(), encodedSize);
 
     // Compute and print MD5 hash of the session key for verification
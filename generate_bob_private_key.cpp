@@ -2,20 +2,10 @@
 #include <fstream>
 #include <cryptopp/integer.h>
 #include <cryptopp/osrng.h>
+#include "private_key.h"
 
 using namespace CryptoPP;
 
-void generate_private_key(Integer &private_key, const Integer &q, AutoSeededRandomPool &rng) {
-    // Generate a random number in the range [1, q-1]
-    while (true) {
-        private_key.Randomize(rng, q.BitCount() - 1);
-        // Ensure the private key is in the range [1, q-1]
-        if (private_key > 0 && private_key < q) {
-            break;
-        }
-    }
-}
-
 void generate_bob_private_key() {
     AutoSeededRandomPool rng;
     Integer g, p, q, beta;
@@ -32,14 +22,8 @@ void generate_bob_private_key() {
     // Generate private key for Bob (β)
     generate_private_key(beta, q, rng);
 
-    // Debug: Print the generated private key
-    std::cout << "Private Key Beta (Bob): " << beta << std::endl;
-
     // Save private key to file
-    std::ofstream fileB("privatekeyB.bin", std::ios::binary);
-    if (fileB) {
-        fileB << beta;
-        fileB.close();
+    if (save_secret_integer("privatekeyB.bin", beta)) {
         std::cout << "Private key for Bob saved to privatekeyB.bin" << std::endl;
     } else {
         std::cerr << "Error: Unable to save private key for Bob." << std::endl;
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <cryptopp/integer.h>
 #include <cryptopp/osrng.h>
+#include "secure_arena.h"
+#include "fixed_bigint.h"
 
 using namespace CryptoPP;
 
@@ -9,16 +11,13 @@ void generate_public_key(const std::string &private_key_file, const std::string
     Integer private_key, public_key;
 
     // Read the private key from the file
-    std::ifstream priv_file(private_key_file, std::ios::binary);
-    if (!priv_file) {
+    if (!load_secret_integer(private_key_file, private_key)) {
         std::cerr << "Error: Unable to open " << private_key_file << " file." << std::endl;
         return;
     }
-    priv_file >> private_key;
-    priv_file.close();
 
     // Calculate the public key: K = g^private_key mod p
-    public_key = a_exp_b_mod_c(g, private_key, p);
+    public_key = a_exp_b_mod_c_fixed(g, private_key, p);
 
     // Debug: Print the generated public key
     std::cout << "Public Key (" << public_key_file << "): " << public_key << std::endl;
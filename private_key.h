@@ -0,0 +1,43 @@
+#ifndef PRIVATE_KEY_H
+#define PRIVATE_KEY_H
+
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/integer.h>
+#include "secure_arena.h"
+
+// Private key sampling shared by generate_*_private_key, rotate_certificates and
+// simulate_parties. Kept apart from certificate_issuer.h so the key tools build without
+// the DSA, hashing and Base64 code issuance needs.
+
+// Size in bytes of a private key for subgroup order q
+inline size_t private_key_size(const CryptoPP::Integer &q) {
+    return (q.BitCount() - 1 + 7) / 8;
+}
+
+// Big-endian private key in [1, q-1], written straight into private_key_size(q) bytes of
+// caller storage. Candidates have one bit fewer than q, so only zero is ever redrawn.
+inline void generate_private_key(CryptoPP::byte *private_key, const CryptoPP::Integer &q,
+                                 CryptoPP::RandomNumberGenerator &rng) {
+    unsigned int bits = q.BitCount() - 1;
+    size_t size = (bits + 7) / 8;
+    CryptoPP::byte top_mask = static_cast<CryptoPP::byte>(0xFF >> (8 * size - bits));
+    CryptoPP::byte nonzero = 0;
+    while (nonzero == 0) {
+        rng.GenerateBlock(private_key, size);
+        private_key[0] &= top_mask;
+        for (size_t i = 0; i < size; i++) {
+            nonzero |= private_key[i];
+        }
+    }
+}
+
+// Integer form for the key tools, whose key files are Integer text. The candidate is drawn
+// into a locked arena buffer and decoded once.
+inline void generate_private_key(CryptoPP::Integer &private_key, const CryptoPP::Integer &q,
+                                 CryptoPP::RandomNumberGenerator &rng) {
+    SecureBytes candidate(private_key_size(q));
+    generate_private_key(candidate.data(), q, rng);
+    private_key.Decode(candidate.data(), candidate.size());
+}
+
+#endif  // PRIVATE_KEY_H
@@ -0,0 +1,377 @@
+#ifndef REVOCATION_H
+#define REVOCATION_H
+
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// On-disk revocation index, memory-mapped by both revoke_certificate and verify_certificate.
+//
+// Layout: header | Bloom filter | block table | compressed base | tail
+//   - the base holds every revoked serial as of the last compaction, sorted and split
+//     into blocks of kBlockSize; each block stores varint deltas after its first serial
+//   - the block table holds {first serial, byte offset} per block for binary search
+//   - the tail is a preallocated, sorted array of raw serials revoked since then;
+//     appends insert into it and set Bloom bits in place, so no rebuild is needed
+//     until the tail fills up and gets merged into the base
+// A lookup is one Bloom probe, and on a hit one binary search plus one block decode.
+//
+// Writers (append, compact) hold an flock on <index>.lock from open() until close(), so
+// concurrent revoke_certificate and rotate_certificates runs are serialized. Readers take
+// no lock: compaction renames a new file into place, and in-place tail inserts are
+// bracketed by tail_sequence (odd while an insert is in progress) so a lookup that races
+// an insert retries instead of missing a serial.
+
+struct RevocationHeader {
+    char magic[8];
+    uint64_t bloom_bits;     // power of two
+    uint64_t bloom_hashes;
+    uint64_t base_count;
+    uint64_t block_count;
+    uint64_t data_bytes;
+    uint64_t tail_count;
+    uint64_t tail_capacity;
+    uint64_t tail_sequence;
+};
+
+struct RevocationBlock {
+    uint64_t first;
+    uint64_t offset;
+};
+
+class RevocationIndex {
+public:
+    static constexpr uint64_t kBlockSize = 128;
+    static constexpr uint64_t kMinTailCapacity = 4096;
+    static constexpr int kMaxReadRetries = 1000;
+
+    RevocationIndex() = default;
+    RevocationIndex(const RevocationIndex &) = delete;
+    RevocationIndex &operator=(const RevocationIndex &) = delete;
+    ~RevocationIndex() { close(); }
+
+    // Map an existing index. When writable is set, take the writer lock until close() and
+    // create a missing file empty.
+    bool open(const std::string &indexPath, bool writable) {
+        close();
+        path = indexPath;
+        this->writable = writable;
+        if (writable) {
+            std::string lockPath = path + ".lock";
+            lock_fd = ::open(lockPath.c_str(), O_RDWR | O_CREAT, 0600);
+            if (lock_fd < 0 || flock(lock_fd, LOCK_EX) != 0) {
+                std::cerr << "Error: Unable to lock revocation index " << path << std::endl;
+                close();
+                return false;
+            }
+            if (access(path.c_str(), F_OK) != 0 && !rewrite(std::vector<uint64_t>())) {
+                close();
+                return false;
+            }
+        }
+        if (!map()) {
+            close();
+            return false;
+        }
+        // A writer that died mid-insert leaves the sequence odd; merging the tail repairs it
+        if (writable && (header->tail_sequence & 1) && !compact()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        unmap();
+        if (lock_fd >= 0) {
+            flock(lock_fd, LOCK_UN);
+            ::close(lock_fd);
+        }
+        lock_fd = -1;
+    }
+
+    bool is_revoked(uint64_t serial) const {
+        if (header == nullptr || !bloom_contains(serial)) {
+            return false;
+        }
+        return tail_contains(serial) || base_contains(serial);
+    }
+
+    // Add serials to the tail in place; merges into the base only when the tail is full.
+    // added is set to the number of serials that were not already revoked.
+    bool append(const std::vector<uint64_t> &serials, uint64_t &added) {
+        std::vector<uint64_t> fresh;
+        for (uint64_t serial : serials) {
+            if (!is_revoked(serial) && std::find(fresh.begin(), fresh.end(), serial) == fresh.end()) {
+                fresh.push_back(serial);
+            }
+        }
+        added = fresh.size();
+        if (header->tail_count + fresh.size() > header->tail_capacity) {
+            std::vector<uint64_t> all = all_serials();
+            all.insert(all.end(), fresh.begin(), fresh.end());
+            return rewrite(all) && map();
+        }
+        for (uint64_t serial : fresh) {
+            bloom_insert(serial);
+            tail_insert(serial);
+        }
+        return msync(mapping, mapping_size, MS_SYNC) == 0;
+    }
+
+    // Merge the tail into the compressed base and resize the Bloom filter
+    bool compact() {
+        return rewrite(all_serials()) && map();
+    }
+
+    uint64_t size() const {
+        return header ? header->base_count + header->tail_count : 0;
+    }
+
+private:
+    std::string path;
+    bool writable = false;
+    int lock_fd = -1;
+    unsigned char *mapping = nullptr;
+    size_t mapping_size = 0;
+    RevocationHeader *header = nullptr;
+    const unsigned char *bloom = nullptr;
+    const RevocationBlock *blocks = nullptr;
+    const unsigned char *data = nullptr;
+    uint64_t *tail = nullptr;
+
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    bool bloom_contains(uint64_t serial) const {
+        uint64_t h1 = mix(serial), h2 = mix(h1) | 1;
+        for (uint64_t i = 0; i < header->bloom_hashes; i++) {
+            uint64_t bit = (h1 + i * h2) & (header->bloom_bits - 1);
+            if (!(bloom[bit >> 3] & (1u << (bit & 7)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void bloom_insert(uint64_t serial) {
+        unsigned char *bits = const_cast<unsigned char *>(bloom);
+        uint64_t h1 = mix(serial), h2 = mix(h1) | 1;
+        for (uint64_t i = 0; i < header->bloom_hashes; i++) {
+            uint64_t bit = (h1 + i * h2) & (header->bloom_bits - 1);
+            bits[bit >> 3] |= static_cast<unsigned char>(1u << (bit & 7));
+        }
+    }
+
+    // Insert keeping the tail sorted. The last serial is first copied into the free slot and
+    // tail_count bumped, then the rest shift up highest first, so at every instant the
+    // visible tail is sorted and still holds every serial it held before.
+    void tail_insert(uint64_t serial) {
+        uint64_t count = header->tail_count;
+        uint64_t pos = static_cast<uint64_t>(std::lower_bound(tail, tail + count, serial) - tail);
+        __atomic_store_n(&header->tail_sequence, header->tail_sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        __atomic_store_n(&tail[count], count > pos ? tail[count - 1] : serial, __ATOMIC_RELEASE);
+        __atomic_store_n(&header->tail_count, count + 1, __ATOMIC_RELEASE);
+        if (count > pos) {
+            for (uint64_t i = count - 1; i > pos; i--) {
+                __atomic_store_n(&tail[i], tail[i - 1], __ATOMIC_RELEASE);
+            }
+            __atomic_store_n(&tail[pos], serial, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&header->tail_sequence, header->tail_sequence + 1, __ATOMIC_RELEASE);
+    }
+
+    // A hit is always genuine; a miss is only trusted if no insert overlapped the search
+    bool tail_contains(uint64_t serial) const {
+        for (int attempt = 0;; attempt++) {
+            uint64_t before = __atomic_load_n(&header->tail_sequence, __ATOMIC_ACQUIRE);
+            uint64_t count = std::min(__atomic_load_n(&header->tail_count, __ATOMIC_ACQUIRE), header->tail_capacity);
+            bool found = std::binary_search(tail, tail + count, serial);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            uint64_t after = __atomic_load_n(&header->tail_sequence, __ATOMIC_RELAXED);
+            if (found || (!(before & 1) && before == after) || attempt == kMaxReadRetries) {
+                return found;
+            }
+            sched_yield();
+        }
+    }
+
+    bool base_contains(uint64_t serial) const {
+        const RevocationBlock *end = blocks + header->block_count;
+        const RevocationBlock *block = std::upper_bound(blocks, end, serial,
+            [](uint64_t value, const RevocationBlock &b) { return value < b.first; });
+        if (block == blocks) {
+            return false;
+        }
+        --block;
+        uint64_t index = static_cast<uint64_t>(block - blocks);
+        uint64_t count = std::min(kBlockSize, header->base_count - index * kBlockSize);
+        const unsigned char *p = data + block->offset;
+        uint64_t value = block->first;
+        for (uint64_t i = 1; i < count && value < serial; i++) {
+            value += read_varint(p);
+        }
+        return value == serial;
+    }
+
+    static uint64_t read_varint(const unsigned char *&p) {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            unsigned char byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+    }
+
+    static void write_varint(std::vector<unsigned char> &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    std::vector<uint64_t> all_serials() const {
+        std::vector<uint64_t> serials;
+        serials.reserve(size());
+        for (uint64_t b = 0; b < header->block_count; b++) {
+            uint64_t count = std::min(kBlockSize, header->base_count - b * kBlockSize);
+            const unsigned char *p = data + blocks[b].offset;
+            uint64_t value = blocks[b].first;
+            serials.push_back(value);
+            for (uint64_t i = 1; i < count; i++) {
+                value += read_varint(p);
+                serials.push_back(value);
+            }
+        }
+        serials.insert(serials.end(), tail, tail + header->tail_count);
+        return serials;
+    }
+
+    // Write a fresh index holding exactly these serials to a temporary file and rename it over
+    bool rewrite(std::vector<uint64_t> serials) {
+        std::sort(serials.begin(), serials.end());
+        serials.erase(std::unique(serials.begin(), serials.end()), serials.end());
+
+        std::vector<RevocationBlock> table;
+        std::vector<unsigned char> compressed;
+        for (size_t i = 0; i < serials.size(); i++) {
+            if (i % kBlockSize == 0) {
+                table.push_back({serials[i], compressed.size()});
+            } else {
+                write_varint(compressed, serials[i] - serials[i - 1]);
+            }
+        }
+
+        RevocationHeader fresh = {};
+        std::memcpy(fresh.magic, "DHREVOK1", 8);
+        fresh.tail_capacity = std::max<uint64_t>(kMinTailCapacity, serials.size() / 8);
+        fresh.bloom_bits = 1024;
+        while (fresh.bloom_bits < (serials.size() + fresh.tail_capacity) * 10) {  // ~1% false positives
+            fresh.bloom_bits <<= 1;
+        }
+        fresh.bloom_hashes = 7;
+        fresh.base_count = serials.size();
+        fresh.block_count = table.size();
+        fresh.data_bytes = compressed.size();
+
+        unmap();
+        mapping_size = layout_size(fresh);
+        mapping = new unsigned char[mapping_size]();
+        header = reinterpret_cast<RevocationHeader *>(mapping);
+        *header = fresh;
+        assign_sections();
+        std::copy(table.begin(), table.end(), const_cast<RevocationBlock *>(blocks));
+        std::copy(compressed.begin(), compressed.end(), const_cast<unsigned char *>(data));
+        for (uint64_t serial : serials) {
+            bloom_insert(serial);
+        }
+
+        std::string tmpPath = path + ".tmp";
+        FILE *out = std::fopen(tmpPath.c_str(), "wb");
+        bool ok = out && std::fwrite(mapping, 1, mapping_size, out) == mapping_size;
+        ok = out && std::fclose(out) == 0 && ok;
+        delete[] mapping;
+        mapping = nullptr;
+        header = nullptr;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error: Unable to write revocation index " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    static size_t layout_size(const RevocationHeader &h) {
+        return sizeof(RevocationHeader) + h.bloom_bits / 8 + h.block_count * sizeof(RevocationBlock) +
+               ((h.data_bytes + 7) & ~static_cast<uint64_t>(7)) + h.tail_capacity * sizeof(uint64_t);
+    }
+
+    void assign_sections() {
+        unsigned char *p = mapping + sizeof(RevocationHeader);
+        bloom = p;
+        p += header->bloom_bits / 8;
+        blocks = reinterpret_cast<const RevocationBlock *>(p);
+        p += header->block_count * sizeof(RevocationBlock);
+        data = p;
+        p += (header->data_bytes + 7) & ~static_cast<uint64_t>(7);
+        tail = reinterpret_cast<uint64_t *>(p);
+    }
+
+    bool map() {
+        int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            std::cerr << "Error: Unable to open revocation index " << path << std::endl;
+            return false;
+        }
+        int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void *ptr = static_cast<size_t>(st.st_size) >= sizeof(RevocationHeader)
+                        ? mmap(nullptr, st.st_size, prot, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            std::cerr << "Error: Unable to map revocation index " << path << std::endl;
+            return false;
+        }
+        mapping = static_cast<unsigned char *>(ptr);
+        mapping_size = static_cast<size_t>(st.st_size);
+        header = reinterpret_cast<RevocationHeader *>(mapping);
+        if (std::memcmp(header->magic, "DHREVOK1", 8) != 0 || layout_size(*header) != mapping_size) {
+            std::cerr << "Error: " << path << " is not a valid revocation index." << std::endl;
+            unmap();
+            return false;
+        }
+        assign_sections();
+        return true;
+    }
+
+    void unmap() {
+        if (mapping != nullptr) {
+            munmap(mapping, mapping_size);
+        }
+        mapping = nullptr;
+        mapping_size = 0;
+        header = nullptr;
+    }
+};
+
+#endif  // REVOCATION_H
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include "revocation.h"
+
+// Decimal serial, as issued: digits only, at least 1 (0 is next_serial_number's failure
+// value, never a real serial) and within 64 bits
+bool parse_serial(const std::string &text, uint64_t &serial) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    errno = 0;
+    serial = std::strtoull(text.c_str(), nullptr, 10);
+    return errno != ERANGE && serial != 0;
+}
+
+// Read the serial number out of an issued certificate file
+bool read_certificate_serial(const std::string &certFilePath, uint64_t &serial) {
+    std::ifstream certFile(certFilePath);
+    if (!certFile) {
+        std::cerr << "Error: Unable to open " << certFilePath << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(certFile, line)) {
+        if (line.compare(0, 15, "Serial Number: ") == 0) {
+            std::string value = line.substr(15, line.find_last_not_of("\r") + 1 - 15);
+            if (!parse_serial(value, serial)) {
+                std::cerr << "Error: Invalid serial number \"" << value << "\" in " << certFilePath << std::endl;
+                return false;
+            }
+            return true;
+        }
+    }
+    std::cerr << "Serial number not found in " << certFilePath << std::endl;
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--compact") {
+        RevocationIndex index;
+        if (!index.open(argv[2], true) || !index.compact()) {
+            return 1;
+        }
+        std::cout << "Revocation index " << argv[2] << " compacted (" << index.size() << " serials)." << std::endl;
+        return 0;
+    }
+
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <revocation_index> <serial | certificate_file>..." << std::endl;
+        std::cerr << "       " << argv[0] << " --compact <revocation_index>" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint64_t> serials;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        uint64_t serial;
+        if (arg.find_first_not_of("0123456789") == std::string::npos) {
+            if (!parse_serial(arg, serial)) {
+                std::cerr << "Error: Invalid serial number \"" << arg << "\"" << std::endl;
+                return 1;
+            }
+            serials.push_back(serial);
+            continue;
+        }
+        if (!read_certificate_serial(arg, serial)) {
+            return 1;
+        }
+        serials.push_back(serial);
+    }
+
+    RevocationIndex index;
+    uint64_t added = 0;
+    if (!index.open(argv[1], true) || !index.append(serials, added)) {
+        return 1;
+    }
+    std::cout << "Revoked " << added << " certificate(s); " << argv[1] << " now holds "
+              << index.size() << " serials." << std::endl;
+    return 0;
+}
+
+// g++ -std=c++17 Lab_Codes/Lab_6/revoke_certificate.cpp -o revoke_certificate
+
+// ./revoke_certificate CA_Revoked.bin CertificateA.bin
+// ./revoke_certificate CA_Revoked.bin 17 42
+// ./revoke_certificate --compact CA_Revoked.bin
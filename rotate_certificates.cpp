@@ -0,0 +1,146 @@
+#include <cryptopp/dsa.h>
+#include <cryptopp/osrng.h>
+#include <cryptopp/files.h>
+#include <cryptopp/integer.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include "private_key.h"
+#include "fixed_bigint.h"
+#include "certificate_issuer.h"
+#include "expiry_index.h"
+#include "revocation.h"
+
+using namespace CryptoPP;
+
+// Renews every certificate whose NotAfter falls inside the renewal window: a new DH key
+// pair for the subject, a freshly signed certificate published over the old one, and
+// (optionally) the superseded serial added to the revocation index. Due certificates come
+// from the front of CA_Expiry.bin, so a run costs O(certificates due), not O(fleet).
+
+// Key files follow the repo's naming (publicKeyA.bin <-> privatekeyA.bin); anything else
+// gets its private key next to the public key with a .priv suffix
+std::string private_key_file_for(const std::string &pubKeyFile) {
+    size_t slash = pubKeyFile.find_last_of('/');
+    size_t base = slash == std::string::npos ? 0 : slash + 1;
+    if (pubKeyFile.compare(base, 9, "publicKey") == 0) {
+        return pubKeyFile.substr(0, base) + "privatekey" + pubKeyFile.substr(base + 9);
+    }
+    return pubKeyFile + ".priv";
+}
+
+// Write through a temporary file so readers never see a half-written key or certificate
+bool publish_file(const std::string &path, const std::string &contents) {
+    std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary);
+    out << contents;
+    out.close();
+    if (!out || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Unable to write " << path << std::endl;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool rotate_certificate(const ExpiryRecord &old, const Integer &g, const Integer &p, const Integer &q,
+                        const DSA::PrivateKey &caPrivateKey, AutoSeededRandomPool &rng, ExpiryRecord &renewed) {
+    std::string subject = old.subject, certFile = old.cert_file, pubKeyFile = old.pub_key_file;
+
+    // New DH key pair for the subject
+    Integer private_key, public_key;
+    generate_private_key(private_key, q, rng);
+    public_key = a_exp_b_mod_c_fixed(g, private_key, p);
+
+    uint64_t serial = next_serial_number("CA_Serial.bin");
+    if (serial == 0) {
+        std::cerr << "Error: Unable to assign a serial number from CA_Serial.bin" << std::endl;
+        return false;
+    }
+
+    std::time_t notAfter = get_expiration_time();
+    std::string certificate = build_signed_certificate(subject, serial, std::time(nullptr), notAfter, public_key,
+                                                       caPrivateKey, rng);
+
+    // Publish keys first, then the certificate that vouches for them
+    // The private key goes through the secure arena, not an ostringstream
+    std::string privKeyFile = private_key_file_for(pubKeyFile);
+    if (!save_secret_integer(privKeyFile, private_key)) {
+        std::cerr << "Error: Unable to write " << privKeyFile << std::endl;
+        return false;
+    }
+    std::ostringstream pubText;
+    pubText << public_key;
+    if (!publish_file(pubKeyFile, pubText.str()) ||
+        !publish_file(certFile, certificate)) {
+        return false;
+    }
+
+    std::cout << "Rotated " << certFile << " (" << subject << "): serial " << old.serial << " -> " << serial << std::endl;
+    return ExpiryIndex::make_record(renewed, notAfter, serial, subject, certFile, pubKeyFile);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <ca_priv_key_file> <renewal_window_days> [revocation_index]" << std::endl;
+        return 1;
+    }
+    std::string caPrivKeyFile = argv[1];
+    long windowDays = std::atol(argv[2]);
+
+    Integer g, p, q;
+    std::ifstream params_file("params.bin", std::ios::binary);
+    if (!params_file) {
+        std::cerr << "Error: Unable to open params.bin file." << std::endl;
+        return 1;
+    }
+    params_file >> g >> p >> q;
+    params_file.close();
+
+    DSA::PrivateKey caPrivateKey;
+    FileSource privFile(caPrivKeyFile.c_str(), true);
+    caPrivateKey.Load(privFile);
+
+    // Holding the index lock for the whole run keeps concurrent issuers and rotations ordered
+    ExpiryIndex expiryIndex;
+    std::vector<ExpiryRecord> due;
+    std::time_t cutoff = std::time(nullptr) + windowDays * 24 * 60 * 60;
+    if (!expiryIndex.open("CA_Expiry.bin") || !expiryIndex.due(cutoff, due)) {
+        return 1;
+    }
+
+    AutoSeededRandomPool rng;
+    std::vector<ExpiryRecord> renewed;
+    std::vector<uint64_t> superseded;
+    for (const ExpiryRecord &record : due) {
+        ExpiryRecord fresh;
+        if (!rotate_certificate(record, g, p, q, caPrivateKey, rng, fresh)) {
+            break;
+        }
+        renewed.push_back(fresh);
+        superseded.push_back(record.serial);
+    }
+
+    // Records are rotated oldest first, so the completed ones are exactly a prefix
+    bool ok = expiryIndex.replace_prefix(renewed.size(), renewed);
+
+    if (argc == 4 && !superseded.empty()) {
+        RevocationIndex revocations;
+        uint64_t added = 0;
+        ok = ok && revocations.open(argv[3], true) && revocations.append(superseded, added);
+    }
+
+    std::cout << "Rotated " << renewed.size() << " of " << due.size() << " certificates due within "
+              << windowDays << " days; " << expiryIndex.size() << " certificates tracked." << std::endl;
+    return ok && renewed.size() == due.size() ? 0 : 1;
+}
+
+// g++ -std=c++17 -O2 -I/opt/homebrew/Cellar/cryptopp/8.9.0/include -L/opt/homebrew/Cellar/cryptopp/8.9.0/lib Lab_Codes/Lab_6/rotate_certificates.cpp -lcryptopp -o rotate_certificates
+
+// ./rotate_certificates CA_Priv.bin 30
+// ./rotate_certificates CA_Priv.bin 30 CA_Revoked.bin
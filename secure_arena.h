@@ -0,0 +1,215 @@
+#ifndef SECURE_ARENA_H
+#define SECURE_ARENA_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cryptopp/misc.h>
+#include <cryptopp/integer.h>
+
+// Per-thread pool of mlock'ed pages for secret material (private keys, session keys and
+// their encoded bytes). Blocks are handed out in power-of-two size classes, wiped on
+// release and kept on a free list, so the buffers we own (encoded keys, key file text)
+// never go back to malloc. A block must be released on the thread that acquired it.
+//
+// Not covered: Crypto++ Integer keeps its limbs in its own heap SecBlock. Those are wiped
+// when freed but are neither locked nor pooled. Keys kept as arena bytes avoid Integer
+// altogether: the byte overloads of generate_private_key (private_key.h) and
+// a_exp_b_mod_c_fixed (fixed_bigint.h) work in caller buffers and stack limbs, so with a
+// 2048- or 3072-bit p they make no heap allocation once warm. The key tools still go
+// through Integer, because their key files are Integer text.
+class SecureArena {
+public:
+    static const size_t kMinBlock = 64;
+    static const size_t kMaxBlock = 4096;
+    static const size_t kSlabSize = 64 * 1024;
+
+    static SecureArena &local() {
+        thread_local SecureArena arena;
+        return arena;
+    }
+
+    void *acquire(size_t size) {
+        if (size > kMaxBlock) {
+            return map_locked(round_to_page(size));
+        }
+        size_t cls = size_class(size);
+        std::vector<void *> &free_list = free_lists[cls];
+        if (free_list.empty()) {
+            carve_slab(cls);
+        }
+        void *block = free_list.back();
+        free_list.pop_back();
+        return block;
+    }
+
+    void release(void *ptr, size_t size) {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (size > kMaxBlock) {
+            size_t mapped = round_to_page(size);
+            CryptoPP::SecureWipeBuffer(static_cast<CryptoPP::byte *>(ptr), mapped);
+            munlock(ptr, mapped);
+            munmap(ptr, mapped);
+            return;
+        }
+        size_t cls = size_class(size);
+        CryptoPP::SecureWipeBuffer(static_cast<CryptoPP::byte *>(ptr), kMinBlock << cls);
+        free_lists[cls].push_back(ptr);
+    }
+
+    ~SecureArena() {
+        for (void *slab : slabs) {
+            CryptoPP::SecureWipeBuffer(static_cast<CryptoPP::byte *>(slab), kSlabSize);
+            munlock(slab, kSlabSize);
+            munmap(slab, kSlabSize);
+        }
+    }
+
+private:
+    static const size_t kClassCount = 7;  // 64, 128, ..., 4096
+
+    std::vector<void *> free_lists[kClassCount];
+    std::vector<void *> slabs;
+
+    SecureArena() = default;
+    SecureArena(const SecureArena &) = delete;
+    SecureArena &operator=(const SecureArena &) = delete;
+
+    static size_t size_class(size_t size) {
+        size_t cls = 0;
+        while ((kMinBlock << cls) < size) {
+            cls++;
+        }
+        return cls;
+    }
+
+    static size_t round_to_page(size_t size) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (size + page - 1) / page * page;
+    }
+
+    static void *map_locked(size_t size) {
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // mlock can fail under a low RLIMIT_MEMLOCK; the pages are still wiped on release,
+        // but may reach swap, so say so once per process
+        if (mlock(ptr, size) != 0) {
+            static std::atomic<bool> reported(false);
+            if (!reported.exchange(true)) {
+                std::cerr << "Warning: Unable to lock secret memory (" << std::strerror(errno)
+                          << "); key material may be swapped to disk." << std::endl;
+            }
+        }
+        return ptr;
+    }
+
+    void carve_slab(size_t cls) {
+        void *slab = map_locked(kSlabSize);
+        slabs.push_back(slab);
+        size_t block_size = kMinBlock << cls;
+        std::vector<void *> &free_list = free_lists[cls];
+        free_list.reserve(free_list.size() + kSlabSize / block_size);
+        for (size_t offset = kSlabSize; offset >= block_size; offset -= block_size) {
+            free_list.push_back(static_cast<CryptoPP::byte *>(slab) + offset - block_size);
+        }
+    }
+};
+
+// std-compatible allocator over the calling thread's SecureArena, so secret buffers can
+// keep using std::vector: std::vector<byte, SecureArenaAllocator<byte>>.
+template <class T>
+struct SecureArenaAllocator {
+    typedef T value_type;
+
+    SecureArenaAllocator() = default;
+    template <class U>
+    SecureArenaAllocator(const SecureArenaAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(SecureArena::local().acquire(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        SecureArena::local().release(ptr, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const SecureArenaAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const SecureArenaAllocator<U> &) const { return false; }
+};
+
+typedef std::vector<CryptoPP::byte, SecureArenaAllocator<CryptoPP::byte>> SecureBytes;
+typedef std::basic_string<char, std::char_traits<char>, SecureArenaAllocator<char>> SecureString;
+typedef std::basic_ostringstream<char, std::char_traits<char>, SecureArenaAllocator<char>> SecureOStringStream;
+
+// Key files hold Integer's decimal text. These read and write them with plain read/write
+// on arena buffers instead of fstream, whose internal buffers are neither locked nor wiped.
+// Writes go through <path>.tmp and a rename, so a key file is never seen half-written.
+inline bool save_secret_integer(const std::string &path, const CryptoPP::Integer &value) {
+    SecureOStringStream text;
+    text << value;
+    SecureString contents = text.str();
+    std::string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    bool ok = fd >= 0;
+    for (size_t done = 0; ok && done < contents.size();) {
+        ssize_t n = ::write(fd, contents.data() + done, contents.size() - done);
+        ok = n > 0;
+        done += ok ? static_cast<size_t>(n) : 0;
+    }
+    ok = fd >= 0 && ::close(fd) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+inline bool load_secret_integer(const std::string &path, CryptoPP::Integer &value) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    SecureString contents(static_cast<size_t>(st.st_size), '\0');
+    size_t done = 0;
+    while (done < contents.size()) {
+        ssize_t n = ::read(fd, &contents[done], contents.size() - done);
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    contents.resize(done);
+    // Integer's constructor reads the radix from the last character ('h', 'o', 'b' or the
+    // '.' that operator<< writes for decimal), so drop any trailing newline first
+    size_t end = contents.find_last_not_of(" \t\r\n");
+    if (end == SecureString::npos) {
+        return false;
+    }
+    contents.resize(end + 1);
+    value = CryptoPP::Integer(contents.c_str());
+    return true;
+}
+
+#endif  // SECURE_ARENA_H
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <cryptopp/integer.h>
 #include <cryptopp/osrng.h>
+#include "fixed_bigint.h"
 
 using namespace CryptoPP;
 
@@ -24,7 +25,7 @@ bool is_prime(const Integer &n, int iterations = 10) {
     for (int i = 0; i < iterations; i++) {
         // Generate a random Integer 'a' in the range [2, n-2]
         Integer a = 2 + Integer(rng, n.BitCount() - 1) % (n - 3);
-        Integer x = a_exp_b_mod_c(a, d, n);
+        Integer x = a_exp_b_mod_c_fixed(a, d, n);
 
         if (x == 1 || x == n - 1)
             continue;
@@ -70,7 +71,7 @@ void setup(int p_size, int q_size) {
     Integer h;
     do {
         h.Randomize(rng, 2, p - 2);  // Randomize h in range [2, p-2]
-        g = a_exp_b_mod_c(h, (p - 1) / q, p);  // g = h^((p-1)/q) mod p
+        g = a_exp_b_mod_c_fixed(h, (p - 1) / q, p);  // g = h^((p-1)/q) mod p
     } while (g == 1);
 
     // Print the generated values
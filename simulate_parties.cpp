@@ -0,0 +1,320 @@
+#include <cryptopp/dsa.h>
+#include <cryptopp/osrng.h>
+#include <cryptopp/integer.h>
+#include <cryptopp/nbtheory.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <unistd.h>
+#include "private_key.h"
+#include "fixed_bigint.h"
+#include "certificate_issuer.h"
+#include "certificate_verifier.h"
+#include "expiry_index.h"
+#include "revocation.h"
+
+using namespace CryptoPP;
+
+// In-process load simulator for the whole PKI + DH workflow. It runs every stage the
+// individual tools run (setupCA, setup, private/public key generation, certificate_generation,
+// revoke_certificate, verify_certificate single and --bundle, session key generation) for N
+// synthetic parties, through the same issuer, index and verifier code the tools use.
+// Parties are spread across threads; every tenth party's certificate is revoked and must
+// be rejected while the rest must verify, every pair's session keys must agree, and each
+// stage's throughput and latency are reported. The serial counter, expiry index and
+// revocation index live in a scratch directory that is removed on exit.
+
+typedef std::chrono::steady_clock Clock;
+
+// Keys are big-endian bytes sized once on the main thread, so the keypair and session_key
+// stages run on the fixed-width byte path without heap allocation. The private key's arena
+// block is acquired and released on the main thread; workers only write into it.
+struct Party {
+    std::string email;
+    SecureBytes private_key;
+    std::vector<byte> public_key;
+    uint64_t serial = 0;
+    bool revoked = false;
+    std::string certificate;
+};
+
+// Per-operation latencies for one stage, merged from all worker threads
+struct StageStats {
+    std::string name;
+    std::vector<double> latencies_us;
+    double wall_ms = 0;
+    std::mutex mutex;
+
+    void merge(std::vector<double> &local) {
+        std::lock_guard<std::mutex> lock(mutex);
+        latencies_us.insert(latencies_us.end(), local.begin(), local.end());
+    }
+
+    void report() {
+        std::sort(latencies_us.begin(), latencies_us.end());
+        size_t count = latencies_us.size();
+        double total = 0;
+        for (double latency : latencies_us) {
+            total += latency;
+        }
+        auto percentile = [&](double p) {
+            return count ? latencies_us[std::min(count - 1, static_cast<size_t>(p * count))] : 0.0;
+        };
+        std::cout << std::left << std::setw(14) << name << std::right
+                  << std::setw(9) << count
+                  << std::setw(12) << std::fixed << std::setprecision(1) << wall_ms
+                  << std::setw(12) << (wall_ms > 0 ? count * 1000.0 / wall_ms : 0.0)
+                  << std::setw(12) << (count ? total / count : 0.0)
+                  << std::setw(12) << percentile(0.50)
+                  << std::setw(12) << percentile(0.99) << "\n";
+    }
+};
+
+// Run op(i) for i in [0, count) on `threads` workers, timing each call into stats
+template <class Op>
+void run_stage(StageStats &stats, size_t count, unsigned int threads, Op op) {
+    std::atomic<size_t> next(0);
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            std::vector<double> local;
+            for (size_t i = next++; i < count; i = next++) {
+                Clock::time_point begin = Clock::now();
+                op(i);
+                local.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+            }
+            stats.merge(local);
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    stats.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Scratch directory for the CA's state files (serial counter, expiry and revocation
+// indexes), so a run exercises the real on-disk formats without touching CA_*.bin
+struct ScratchDir {
+    std::string path;
+
+    bool create() {
+        const char *tmp = std::getenv("TMPDIR");
+        std::string pattern = std::string(tmp ? tmp : "/tmp") + "/simulate_parties.XXXXXX";
+        std::vector<char> name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+        if (mkdtemp(name.data()) == nullptr) {
+            std::cerr << "Error: Unable to create a scratch directory under " << pattern << std::endl;
+            return false;
+        }
+        path = name.data();
+        return true;
+    }
+
+    std::string file(const std::string &name) const {
+        return path + "/" + name;
+    }
+
+    ~ScratchDir() {
+        if (path.empty()) {
+            return;
+        }
+        if (DIR *dir = opendir(path.c_str())) {
+            while (dirent *entry = readdir(dir)) {
+                if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+                    unlink(file(entry->d_name).c_str());
+                }
+            }
+            closedir(dir);
+        }
+        rmdir(path.c_str());
+    }
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <parties> [p_size] [q_size] [threads]" << std::endl;
+        return 1;
+    }
+    size_t parties = std::strtoul(argv[1], nullptr, 10);
+    unsigned int p_size = argc > 2 ? std::atoi(argv[2]) : 2048;
+    unsigned int q_size = argc > 3 ? std::atoi(argv[3]) : 256;
+    unsigned int threads = argc > 4 ? std::atoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+    if (parties < 2 || q_size < 2 || q_size >= p_size || threads == 0) {
+        std::cerr << "Error: need at least 2 parties, q_size < p_size and at least 1 thread." << std::endl;
+        return 1;
+    }
+
+    ScratchDir scratch;
+    if (!scratch.create()) {
+        return 1;
+    }
+    std::string serialFile = scratch.file("CA_Serial.bin");
+    std::string expiryFile = scratch.file("CA_Expiry.bin");
+    std::string revokedFile = scratch.file("CA_Revoked.bin");
+
+    StageStats setupCAStats, paramsStats, keygenStats, signStats, revokeStats, verifyStats, bundleStats, agreeStats;
+    setupCAStats.name = "setupCA";
+    paramsStats.name = "params";
+    keygenStats.name = "keypair";
+    signStats.name = "certificate";
+    revokeStats.name = "revoke";
+    verifyStats.name = "verify";
+    bundleStats.name = "bundle";
+    agreeStats.name = "session_key";
+
+    // setupCA
+    DSA::PrivateKey caPrivateKey;
+    DSA::PublicKey caPublicKey;
+    run_stage(setupCAStats, 1, 1, [&](size_t) {
+        AutoSeededRandomPool rng;
+        caPrivateKey.GenerateRandomWithKeySize(rng, 2048);
+        caPrivateKey.MakePublicKey(caPublicKey);
+    });
+
+    // setup: PrimeAndGenerator(1, ...) builds a Schnorr group, p = 2rq + 1 with g of order
+    // q, in one call, which is far faster than setup's independent p/q search at 2048+ bits
+    Integer p, q, g;
+    run_stage(paramsStats, 1, 1, [&](size_t) {
+        AutoSeededRandomPool rng;
+        PrimeAndGenerator pg(1, rng, p_size, q_size);
+        p = pg.Prime();
+        q = pg.SubPrime();
+        g = pg.Generator();
+    });
+
+    std::vector<Party> party(parties);
+    for (size_t i = 0; i < parties; i++) {
+        party[i].email = "party" + std::to_string(i) + "@example.com";
+        party[i].private_key.resize(private_key_size(q));
+        party[i].public_key.resize(p.ByteCount());
+    }
+    std::vector<byte> generator(p.ByteCount());
+    g.Encode(generator.data(), generator.size());
+    run_stage(keygenStats, parties, threads, [&](size_t i) {
+        thread_local AutoSeededRandomPool rng;
+        generate_private_key(party[i].private_key.data(), q, rng);
+        a_exp_b_mod_c_fixed(generator.data(), generator.size(), party[i].private_key.data(), party[i].private_key.size(),
+                            p, party[i].public_key.data());
+    });
+
+    // certificate_generation: serial from the flock'ed counter, then expiry registration
+    std::atomic<size_t> issueFailures(0);
+    run_stage(signStats, parties, threads, [&](size_t i) {
+        thread_local AutoSeededRandomPool rng;
+        party[i].serial = next_serial_number(serialFile);
+        std::time_t notAfter = get_expiration_time();
+        party[i].certificate = build_signed_certificate(party[i].email, party[i].serial, std::time(nullptr), notAfter,
+                                                        Integer(party[i].public_key.data(), party[i].public_key.size()),
+                                                        caPrivateKey, rng);
+        ExpiryIndex expiryIndex;
+        ExpiryRecord record;
+        std::string name = "party" + std::to_string(i);
+        if (party[i].serial == 0 ||
+            !ExpiryIndex::make_record(record, notAfter, party[i].serial, party[i].email, name + ".cert", name + ".pub") ||
+            !expiryIndex.open(expiryFile) || !expiryIndex.add(record)) {
+            issueFailures++;
+        }
+    });
+    ExpiryIndex expiryIndex;
+    if (!expiryIndex.open(expiryFile) || expiryIndex.size() != parties) {
+        issueFailures++;
+    }
+    expiryIndex.close();
+
+    // revoke_certificate: every tenth party, in one append
+    std::vector<uint64_t> revokedSerials;
+    for (size_t i = 0; i < parties; i += 10) {
+        party[i].revoked = true;
+        revokedSerials.push_back(party[i].serial);
+    }
+    run_stage(revokeStats, 1, 1, [&](size_t) {
+        RevocationIndex writer;
+        uint64_t added = 0;
+        if (!writer.open(revokedFile, true) || !writer.append(revokedSerials, added) || added != revokedSerials.size()) {
+            issueFailures++;
+        }
+    });
+
+    // verify_certificate: revoked parties must be rejected, everyone else accepted
+    RevocationIndex revocations;
+    if (!revocations.open(revokedFile, false)) {
+        return 1;
+    }
+    std::atomic<size_t> unexpected(0);
+    run_stage(verifyStats, parties, threads, [&](size_t i) {
+        std::string error;
+        if (verify_certificate_text(party[i].certificate, caPublicKey, &revocations, error) == party[i].revoked) {
+            unexpected++;
+        }
+    });
+
+    // verify_certificate --bundle: all certificates through the pipeline at once. Latency
+    // here is the time from the start of the bundle until that certificate's result.
+    std::string bundle;
+    for (const Party &member : party) {
+        bundle += member.certificate;
+    }
+    size_t bundleUnexpected = 0;
+    Clock::time_point bundleStart = Clock::now();
+    verify_bundle_data(bundle.data(), bundle.size(), caPublicKey, &revocations, [&](const CertJob &job) {
+        bundleStats.latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - bundleStart).count());
+        if (job.index >= parties || job.error.empty() == party[job.index].revoked) {
+            bundleUnexpected++;
+        }
+    });
+    bundleStats.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - bundleStart).count();
+    bundleUnexpected += parties - std::min(parties, bundleStats.latencies_us.size());
+
+    // Every unordered pair (a, b): a computes pub_b^x_a, b computes pub_a^x_b, and both must agree
+    size_t pairs = parties * (parties - 1) / 2;
+    std::atomic<size_t> mismatched(0);
+    run_stage(agreeStats, pairs, threads, [&](size_t k) {
+        size_t a = 0, remaining = k;
+        while (remaining >= parties - 1 - a) {
+            remaining -= parties - 1 - a;
+            a++;
+        }
+        size_t b = a + 1 + remaining;
+        // Sized at construction so the thread's arena exists first and outlives them
+        thread_local SecureBytes ssnkA(p.ByteCount()), ssnkB(p.ByteCount());
+        a_exp_b_mod_c_fixed(party[b].public_key.data(), party[b].public_key.size(), party[a].private_key.data(),
+                            party[a].private_key.size(), p, ssnkA.data());
+        a_exp_b_mod_c_fixed(party[a].public_key.data(), party[a].public_key.size(), party[b].private_key.data(),
+                            party[b].private_key.size(), p, ssnkB.data());
+        if (ssnkA != ssnkB) {
+            mismatched++;
+        }
+    });
+
+    std::cout << parties << " parties, " << pairs << " pairs, p " << p.BitCount() << " bits, q "
+              << q.BitCount() << " bits, " << threads << " threads\n\n";
+    std::cout << std::left << std::setw(14) << "stage" << std::right << std::setw(9) << "ops"
+              << std::setw(12) << "wall ms" << std::setw(12) << "ops/s" << std::setw(12) << "mean us"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << "\n";
+    for (StageStats *stats : {&setupCAStats, &paramsStats, &keygenStats, &signStats, &revokeStats, &verifyStats,
+                              &bundleStats, &agreeStats}) {
+        stats->report();
+    }
+    std::cout << "\nIssuance failures: " << issueFailures
+              << "\nUnexpected verify results: " << unexpected << " (" << revokedSerials.size() << " revoked)"
+              << "\nUnexpected bundle results: " << bundleUnexpected
+              << "\nSession key mismatches: " << mismatched << std::endl;
+
+    return issueFailures == 0 && unexpected == 0 && bundleUnexpected == 0 && mismatched == 0 ? 0 : 1;
+}
+
+// g++ -std=c++17 -O2 -I/opt/homebrew/Cellar/cryptopp/8.9.0/include -L/opt/homebrew/Cellar/cryptopp/8.9.0/lib Lab_Codes/Lab_6/simulate_parties.cpp -lcryptopp -o simulate_parties
+
+// ./simulate_parties 100
+// ./simulate_parties 1000 3072 256 16
@@ -1,46 +1,96 @@
 #include <cryptopp/dsa.h>
 #include <cryptopp/osrng.h>
 #include <cryptopp/files.h>
-#include <cryptopp/sha.h>
-#include <cryptopp/filters.h>
-#include <cryptopp/base64.h>
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <sstream>
-#include <ctime>
-#include <iomanip>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "revocation.h"
+#include "certificate_verifier.h"
 
 using namespace CryptoPP;
 
-bool IsDateWithinRange(const std::string& notBefore, const std::string& notAfter) {
-    std::time_t now = std::time(nullptr);
-    
-    auto parseDate = [](const std::string& dateStr) -> std::time_t {
-        std::tm tm = {};
-        std::istringstream ss(dateStr);
-        ss >> std::get_time(&tm, "%a, %d %b %Y");
-        return std::mktime(&tm);
-    };
-    
-    std::time_t notBeforeTime = parseDate(notBefore);
-    std::time_t notAfterTime = parseDate(notAfter);
-    
-    return (now >= notBeforeTime && now <= notAfterTime);
+int verify_bundle(const std::string &bundlePath, const std::string &caPubKeyPath, const RevocationIndex *revocations) {
+    DSA::PublicKey caPublicKey;
+    if (!LoadCAPublicKey(caPubKeyPath, caPublicKey)) {
+        return 1;
+    }
+
+    int fd = open(bundlePath.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        std::cerr << "Error: Unable to open " << bundlePath << std::endl;
+        return 1;
+    }
+    size_t bundleSize = static_cast<size_t>(st.st_size);
+    if (bundleSize == 0) {
+        close(fd);
+        std::cerr << "Bundle " << bundlePath << " is empty." << std::endl;
+        return 1;
+    }
+    const char *bundle = static_cast<const char *>(mmap(nullptr, bundleSize, PROT_READ, MAP_PRIVATE, fd, 0));
+    close(fd);
+    if (bundle == MAP_FAILED) {
+        std::cerr << "Error: Unable to map " << bundlePath << std::endl;
+        return 1;
+    }
+    madvise(const_cast<char *>(bundle), bundleSize, MADV_SEQUENTIAL);
+
+    // Stream results as they complete
+    size_t total = 0, failed = 0;
+    verify_bundle_data(bundle, bundleSize, caPublicKey, revocations, [&](const CertJob &job) {
+        total++;
+        if (job.error.empty()) {
+            std::cout << job.index << " " << job.subject << ": OK\n";
+        } else {
+            failed++;
+            std::cout << job.index << " " << job.subject << ": " << job.error << "\n";
+        }
+    });
+    munmap(const_cast<char *>(bundle), bundleSize);
+
+    std::cout << total - failed << " of " << total << " certificates verified." << std::endl;
+    return failed == 0 ? 0 : 1;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <certificate_file> <ca_pub_key_file>" << std::endl;
+    bool bundleMode = argc >= 2 && std::string(argv[1]) == "--bundle";
+    int firstArg = bundleMode ? 2 : 1;
+    if (argc != firstArg + 2 && argc != firstArg + 3) {
+        std::cerr << "Usage: " << argv[0] << " <certificate_file> <ca_pub_key_file> [revocation_index]" << std::endl;
+        std::cerr << "       " << argv[0] << " --bundle <bundle_file> <ca_pub_key_file> [revocation_index]" << std::endl;
         return 1;
     }
 
+    // Optional revocation index maintained by revoke_certificate
+    RevocationIndex revocationIndex;
+    const RevocationIndex *revocations = nullptr;
+    if (argc == firstArg + 3) {
+        if (!revocationIndex.open(argv[firstArg + 2], false)) {
+            return 1;
+        }
+        revocations = &revocationIndex;
+    }
+
+    if (bundleMode) {
+        return verify_bundle(argv[firstArg], argv[firstArg + 1], revocations);
+    }
+
     std::string certFilePath = argv[1];
     std::string caPubKeyFilePath = argv[2];
 
     // Load the CA's public key from the CA_Pub.bin file (DSA)
     DSA::PublicKey caPublicKey;
-    FileSource file(caPubKeyFilePath.c_str(), true);
-    caPublicKey.Load(file);
+    if (!LoadCAPublicKey(caPubKeyFilePath, caPublicKey)) {
+        return 1;
+    }
 
     // Read the certificate file
     std::ifstream certFile(certFilePath);
@@ -48,57 +98,22 @@ int main(int argc, char* argv[]) {
     buffer << certFile.rdbuf();
     std::string certificate = buffer.str();
 
-    // Extract validity period
-    size_t notBeforePos = certificate.find("NotBefore: ");
-    size_t notAfterPos = certificate.find("NotAfter: ");
-    if (notBeforePos == std::string::npos || notAfterPos == std::string::npos) {
-        std::cerr << "Validity period not found in certificate." << std::endl;
+    std::string error;
+    if (!verify_certificate_text(certificate, caPublicKey, revocations, error)) {
+        std::cerr << error << std::endl;
         return 1;
     }
-
-    std::string notBefore = certificate.substr(notBeforePos + 11, 16); // 11 to skip "NotBefore: "
-    std::string notAfter = certificate.substr(notAfterPos + 10, 16);  // 10 to skip "NotAfter: "
-
-    // Check if the certificate is within its validity period
-    if (!IsDateWithinRange(notBefore, notAfter)) {
-        std::cerr << "Certificate is not within its validity period." << std::endl;
-        return 1;
-    }
-
-    // Find the signature position
-    size_t signaturePos = certificate.find("Signature: ");
-    if (signaturePos == std::string::npos) {
-        std::cerr << "Signature not found in certificate." << std::endl;
-        return 1;
-    }
-
-    std::string certData = certificate.substr(0, signaturePos);
-    std::string encodedSignature = certificate.substr(signaturePos + 10); // 10 = length of "Signature: "
-
-    // Decode the Base64-encoded signature
-    std::string signature;
-    StringSource ss(encodedSignature, true, new Base64Decoder(new StringSink(signature)));
-
-    // Generate a hash of the certificate data using SHA-256
-    SHA256 hash;
-    std::string digest;
-    StringSource(certData, true, new HashFilter(hash, new StringSink(digest)));
-
-    // Verify the signature using DSA
-    DSA::Verifier verifier(caPublicKey);
-    bool result = verifier.VerifyMessage((const byte*)digest.data(), digest.size(), 
-                                         (const byte*)signature.data(), signature.size());
-
-    if (result) {
-        std::cout << "Certificate verification succeeded." << std::endl;
-    } else {
-        std::cerr << "Certificate verification failed." << std::endl;
-    }
-
-    return result ? 0 : 1;
+    std::cout << "Certificate verification succeeded." << std::endl;
+    return 0;
 }
 
 // g++ -std=c++17 -I/opt/homebrew/Cellar/cryptopp/8.9.0/include -L/opt/homebrew/Cellar/cryptopp/8.9.0/lib Lab_Codes/Lab_6/verify_certificate.cpp -lcryptopp -o verify_certificate
 
 // ./verify_certificate CertificateA.bin CA_Pub.bin
-// ./verify_certificate CertificateB.bin CA_Pub.bin
\ No newline at end of file
+// ./verify_certificate CertificateB.bin CA_Pub.bin
+
+// cat CertificateA.bin CertificateB.bin > bundle.bin
+// ./verify_certificate --bundle bundle.bin CA_Pub.bin
+
+// ./verify_certificate CertificateA.bin CA_Pub.bin CA_Revoked.bin
+// ./verify_certificate --bundle bundle.bin CA_Pub.bin CA_Revoked.bin
\ No newline at end of file